@@ -1,7 +1,7 @@
 /*******************************************************************************
 * WISMO228 Library
-* Version: 1.30
-* Date: 11-05-2016
+* Version: 1.40
+* Date: 18-10-2026
 * Company: Rocket Scream Electronics
 * Author: Lim Phang Moh
 * Website: www.rocketscream.com
@@ -25,6 +25,51 @@
 *
 * Revision  Description
 * ========  ===========
+* 1.40      Added block data mode (AT+WIPDATARW) for socket data exchange 
+*           without "+++" escape sequence and public socket functions.
+*           Added UDP client with optional sequence number & acknowledgement.
+*           Added MQTT 3.1.1 client (QoS 0 & 1) over a persistent socket.
+*           Added TCP server with accept handler & unsolicited result code 
+*           processing (poll).
+*           Added FTP upload streaming from a user data source.
+*           Added SMTP session (openEmail, closeEmail) to send several emails 
+*           with a single login, using command pipelining if supported. 
+*           Session follows the selected data mode.
+*           Added sending an email to several recipients in one transaction.
+*           Added email attachment encoded into base 64 on the fly.
+*           Added DNS cache of server addresses for TCP client sockets.
+*           Added non blocking ping series with round trip time statistics.
+*           Added signal quality monitor (RSSI & BER averages, RSSI trend) 
+*           with signal aware transmission scheduling hook.
+*           Added response timeouts per class of command learned from 
+*           observed response times.
+*           Added retry policy with exponential backoff & jitter for GPRS 
+*           bearer, socket open & SMS sending, cancellable from the idle 
+*           callback.
+*           Added local timebase synchronized from the module or network clock
+*           with drift correction & periodic resync.
+*           Added AT command queue sending setup commands as a single command
+*           line (power up SMS setup & GPRS bearer configuration).
+*           Added module configuration shadow to skip redundant setup commands
+*           with optional configuration record in EEPROM (setConfigStore).
+*           Added sending a SMS to several recipients over a persistent SMS 
+*           relay link (AT+CMMS) with per recipient results.
+*           Added SMS storage occupancy, module memory selection & proactive 
+*           cleanup.
+*           Added SMS command dispatcher with command table in flash memory.
+*           Added authorised SMS sender whitelist of 32-bit hashes in EEPROM.
+*           Added constructor for any Stream port (used by the Benchmark 
+*           example with a simulated module).
+*           Added compile time feature switches (WISMO228Config.h) & shared 
+*           flash memory strings.
+*           HTTP requests are rendered from templates in flash memory.
+*           Added HTTP POST & PUT with the body streamed from a user data 
+*           source, using chunked transfer encoding if the length is unknown.
+*           Added GPRS link supervisor restoring a lost connection in the 
+*           background (setLinkSupervisor).
+*           MQTT & SMTP sessions have sockets of their own, opening a socket 
+*           which is in use fails right away.
+*
 * 1.30      Changes to SMTP server response handling (more general).
 *           Tested on Arduino IDE 1.0.6. 
 * 1.20      Added support for hardware serial (Serial, Serial1, Serial2, &
@@ -46,41 +91,124 @@
 // ***** INCLUDES *****
 #include "WISMO228.h"
 #include <Arduino.h>
+#include <avr/eeprom.h>
+#include <ctype.h>
 
 // ***** CONSTANTS *****
 // ***** EXPECTED WISMO228 RESPONSE *****
 prog_char ok[] PROGMEM = "OK"; 
 prog_char simOk[] PROGMEM = "\r\n+CPIN: READY\r\n\r\nOK\r\n";
-prog_char networkOk[] PROGMEM = "\r\n+CREG: 0,1\r\n\r\nOK\r\n";
-prog_char smsCursor[] PROGMEM = "> ";
+prog_char networkStatus[] PROGMEM = "+CREG: ";
+prog_char newLine[] PROGMEM = "\r\n";
+prog_char carriegeReturn[] PROGMEM = "\r";
+prog_char lineFeed[] PROGMEM = "\n";
+prog_char rssiCheck[] PROGMEM = "\r\n+CSQ: ";
+prog_char errorReply[] PROGMEM = "ERROR";
+// Data prompt of both SMS & block data mode
+prog_char writeCursor[] PROGMEM = "> ";
+#if WISMO228_SMS
 prog_char smsSendOk[] PROGMEM = "\r\n+CMGS: ";
 prog_char smsList[] PROGMEM = "\r\n+CMGL: ";
 prog_char smsUnread[] PROGMEM = "\"REC UNREAD\",\"+";
 prog_char commaQuoteMark[] PROGMEM = ",\"";
 prog_char quoteMark[] PROGMEM = "\"";
-prog_char newLine[] PROGMEM = "\r\n";
-prog_char carriegeReturn[] PROGMEM = "\r";
-prog_char lineFeed[] PROGMEM = "\n";
-prog_char pingOk[] PROGMEM = "\r\nOK\r\n\r\n+WIPPING: 0,0,";
+prog_char smsStorage[] PROGMEM = "+CPMS: \"";
+prog_char moduleStorage[] PROGMEM = "\"ME\"";
+#endif
+#if WISMO228_CLOCK
 prog_char clockOk[] PROGMEM = "\r\n+CCLK: \"";
-prog_char rssiCheck[] PROGMEM = "\r\n+CSQ: ";
-prog_char portOk[] PROGMEM = "+WIPREADY: 2,1\r\n";
+#endif
+#if WISMO228_GPRS
+prog_char bearerUp[] PROGMEM = "+WIPBR: 6,1";
+prog_char portOk[] PROGMEM = "+WIPREADY: 2,";
 prog_char connectOk[] PROGMEM = "\r\nCONNECT\r\n";
-prog_char dataOk[] PROGMEM = "\r\n+WIPDATA: 2,1,";
-prog_char smtpUsernamePrompt[] PROGMEM = "334 VXNlcm5hbWU6\r\n";
-prog_char smtpPasswordPrompt[] PROGMEM = "334 UGFzc3dvcmQ6\r\n";
+prog_char blockRead[] PROGMEM = "+WIPDATARW: ";
+// Printed from several places, shared through a cast to a flash string
+prog_char blockCommand[] PROGMEM = "AT+WIPDATARW=";
+prog_char escapeSequence[] PROGMEM = "+++";
+prog_char peerAddress[] PROGMEM = "+WIPOPT: 2,2,\"";
+#endif
+#if WISMO228_HTTP
+prog_char shutdownLink[] PROGMEM = "SHUTDOWN";
+#endif
+
+#if WISMO228_HTTP
+// ***** HTTP REQUEST TEMPLATES *****
+// %0 - %9 are replaced by the corresponding request field
+prog_char httpGetTemplate[] PROGMEM = "GET %0 HTTP/1.1\r\nHost: %1\r\n\r\n";
+prog_char httpPutTemplate[] PROGMEM = "PUT %0 HTTP/1.1\r\nHost: %1\r\n%2\r\n"
+																			"Content-Length: %3\r\n"
+																			"Content-Type: %4\r\n"
+																			"Connection: close\r\n\r\n%5\n";
+prog_char httpStreamTemplate[] PROGMEM = " %0 HTTP/1.1\r\nHost: %1\r\n%2\r\n"
+																				 "Content-Type: %3\r\n"
+																				 "Connection: close\r\n";
+prog_char httpStatus[] PROGMEM = "HTTP/1.";
+#endif
+#if WISMO228_PING
+prog_char pingOk[] PROGMEM = "\r\nOK\r\n\r\n+WIPPING: 0,0,";
+prog_char pingReply[] PROGMEM = "+WIPPING: ";
+prog_char pingCommand[] PROGMEM = "AT+WIPPING=\"";
+#endif
+#if WISMO228_SERVER
+prog_char serverAccept[] PROGMEM = "+WIPACCEPT: ";
+#endif
+#if WISMO228_UDP
+prog_char udpOk[] PROGMEM = "+WIPREADY: 1,1\r\n";
+#endif
+#if WISMO228_FTP
+prog_char ftpOk[] PROGMEM = "+WIPREADY: 4,1\r\n";
+#endif
+#if WISMO228_EMAIL
+prog_char smtpAuthenticationPrompt[] PROGMEM = "334 ";
+prog_char smtpGreeting[] PROGMEM = "220 ";
 prog_char smtpOk[] PROGMEM = "250 ";
+prog_char smtpClosing[] PROGMEM = "221 ";
+prog_char smtpPipeliningKeyword[] PROGMEM = "PIPELINING";
 prog_char smtpAuthenticationOk[] PROGMEM = "235 ";
 prog_char smtpInputPrompt[] PROGMEM = "354 ";
-prog_char shutdownLink[] PROGMEM = "SHUTDOWN";
+#endif
+
+#if WISMO228_UDP
+// ***** HEXADECIMAL TABLE *****
+prog_char hexTable[] PROGMEM = "0123456789ABCDEF";
+#endif
+
+#if WISMO228_MQTT
+// ***** MQTT PROTOCOL NAME & LEVEL *****
+prog_uchar mqttProtocol[] PROGMEM = {0x00, 0x04, 'M', 'Q', 'T', 'T', 0x04};
+#endif
 
+#if WISMO228_EMAIL
 // ***** BASE64 ENCODING TABLE *****
 prog_uchar	base64Table[] PROGMEM =	{"ABCDEFGHIJKLMNOPQRSTUVWXYZ"
 																			"abcdefghijklmnopqrstuvwxyz"
 																			"0123456789+/"};
+#endif
 
 // ***** VARIABLES *****
 char responseBuffer[RESPONSE_LENGTH_MAX];
+#if WISMO228_MQTT
+// Extra byte to terminate received payload as a string
+char mqttBuffer[MQTT_PACKET_MAX + 1];
+#endif
+#if WISMO228_EMAIL
+// Server replies retrieved in block mode but not processed yet
+char smtpBuffer[SMTP_BUFFER_MAX];
+#endif
+
+// ***** CLASSES *****
+// Discards everything printed to it, used to measure the length of a block 
+// before it is sent
+class LengthCounter : public Print
+{
+	public:
+		size_t	write(uint8_t)
+		{
+			return (1);
+		}
+};
+
 
 WISMO228::WISMO228(HardwareSerial *hardwarePort, unsigned char onOffPin)
 {
@@ -89,6 +217,36 @@ WISMO228::WISMO228(HardwareSerial *hardwarePort, unsigned char onOffPin)
   hs->begin(BAUD_RATE);
   uart = hardwarePort;
   _onOffPin = onOffPin;
+  idleFunctionPtr = NULL;
+  retryCancelled = false;
+  commandCount = 0;
+  configShadow = 0;
+  configAddress = CONFIG_STORE_NONE;
+#if WISMO228_GPRS
+  dataMode = DATA_TRANSPARENT;
+  socketsOpen = 0;
+  linkApn = NULL;
+  linkInterval = 0;
+  linkDrops = 0;
+#endif
+#if WISMO228_SERVER
+  acceptFunctionPtr = NULL;
+#endif
+#if WISMO228_MQTT
+  mqttFunctionPtr = NULL;
+  mqttKeepAlive = 0;
+#endif
+#if WISMO228_FTP
+  ftpDuration = 0;
+#endif
+#if WISMO228_EMAIL
+  emailSender = NULL;
+#endif
+#if WISMO228_SMS
+  smsRate = 0;
+  smsCleanup = 0;
+  whitelistSlots = 0;
+#endif
 }
 
 WISMO228::WISMO228(SoftwareSerial *softwarePort, unsigned char onOffPin)
@@ -98,6 +256,74 @@ WISMO228::WISMO228(SoftwareSerial *softwarePort, unsigned char onOffPin)
   ss->begin(BAUD_RATE);
   uart = softwarePort;
   _onOffPin = onOffPin;
+  idleFunctionPtr = NULL;
+  retryCancelled = false;
+  commandCount = 0;
+  configShadow = 0;
+  configAddress = CONFIG_STORE_NONE;
+#if WISMO228_GPRS
+  dataMode = DATA_TRANSPARENT;
+  socketsOpen = 0;
+  linkApn = NULL;
+  linkInterval = 0;
+  linkDrops = 0;
+#endif
+#if WISMO228_SERVER
+  acceptFunctionPtr = NULL;
+#endif
+#if WISMO228_MQTT
+  mqttFunctionPtr = NULL;
+  mqttKeepAlive = 0;
+#endif
+#if WISMO228_FTP
+  ftpDuration = 0;
+#endif
+#if WISMO228_EMAIL
+  emailSender = NULL;
+#endif
+#if WISMO228_SMS
+  smsRate = 0;
+  smsCleanup = 0;
+  whitelistSlots = 0;
+#endif
+}
+
+WISMO228::WISMO228(Stream *port, unsigned char onOffPin)
+{
+  // Port is configured by the caller
+  uart = port;
+  _onOffPin = onOffPin;
+  _ringPin = NC;
+  idleFunctionPtr = NULL;
+  retryCancelled = false;
+  commandCount = 0;
+  configShadow = 0;
+  configAddress = CONFIG_STORE_NONE;
+#if WISMO228_GPRS
+  dataMode = DATA_TRANSPARENT;
+  socketsOpen = 0;
+  linkApn = NULL;
+  linkInterval = 0;
+  linkDrops = 0;
+#endif
+#if WISMO228_SERVER
+  acceptFunctionPtr = NULL;
+#endif
+#if WISMO228_MQTT
+  mqttFunctionPtr = NULL;
+  mqttKeepAlive = 0;
+#endif
+#if WISMO228_FTP
+  ftpDuration = 0;
+#endif
+#if WISMO228_EMAIL
+  emailSender = NULL;
+#endif
+#if WISMO228_SMS
+  smsRate = 0;
+  smsCleanup = 0;
+  whitelistSlots = 0;
+#endif
 }
 
 WISMO228::WISMO228(HardwareSerial *hardwarePort, unsigned char onOffPin, 
@@ -108,6 +334,36 @@ WISMO228::WISMO228(HardwareSerial *hardwarePort, unsigned char onOffPin,
   hs->begin(BAUD_RATE);
   uart = hardwarePort;
   _onOffPin = onOffPin;
+  idleFunctionPtr = NULL;
+  retryCancelled = false;
+  commandCount = 0;
+  configShadow = 0;
+  configAddress = CONFIG_STORE_NONE;
+#if WISMO228_GPRS
+  dataMode = DATA_TRANSPARENT;
+  socketsOpen = 0;
+  linkApn = NULL;
+  linkInterval = 0;
+  linkDrops = 0;
+#endif
+#if WISMO228_SERVER
+  acceptFunctionPtr = NULL;
+#endif
+#if WISMO228_MQTT
+  mqttFunctionPtr = NULL;
+  mqttKeepAlive = 0;
+#endif
+#if WISMO228_FTP
+  ftpDuration = 0;
+#endif
+#if WISMO228_EMAIL
+  emailSender = NULL;
+#endif
+#if WISMO228_SMS
+  smsRate = 0;
+  smsCleanup = 0;
+  whitelistSlots = 0;
+#endif
 	
 	// If either digital pin 2 or 3 is used as RING pin
 	if ((ringPin == 2) || (ringPin == 3))
@@ -130,6 +386,36 @@ WISMO228::WISMO228(SoftwareSerial *softwarePort, unsigned char onOffPin,
   ss->begin(BAUD_RATE);
   uart = softwarePort;
   _onOffPin = onOffPin;
+  idleFunctionPtr = NULL;
+  retryCancelled = false;
+  commandCount = 0;
+  configShadow = 0;
+  configAddress = CONFIG_STORE_NONE;
+#if WISMO228_GPRS
+  dataMode = DATA_TRANSPARENT;
+  socketsOpen = 0;
+  linkApn = NULL;
+  linkInterval = 0;
+  linkDrops = 0;
+#endif
+#if WISMO228_SERVER
+  acceptFunctionPtr = NULL;
+#endif
+#if WISMO228_MQTT
+  mqttFunctionPtr = NULL;
+  mqttKeepAlive = 0;
+#endif
+#if WISMO228_FTP
+  ftpDuration = 0;
+#endif
+#if WISMO228_EMAIL
+  emailSender = NULL;
+#endif
+#if WISMO228_SMS
+  smsRate = 0;
+  smsCleanup = 0;
+  whitelistSlots = 0;
+#endif
 	
 	// If either digital pin 2 or 3 is used as RING pin
 	if ((ringPin == 2) || (ringPin == 3))
@@ -144,6 +430,28 @@ WISMO228::WISMO228(SoftwareSerial *softwarePort, unsigned char onOffPin,
 	}
 }
 
+/*******************************************************************************
+* Name: setConfigStore
+* Description: Persist the power up configuration (echo off, SMS text mode & 
+*							 RING pin setup) in the module profile (AT&W) and record it in 
+*							 EEPROM, so that subsequent power ups skip those commands.
+*							 Must be called before powerUp.
+*
+* Argument  			Description
+* =========  			===========
+* 1. address			EEPROM address of a 2 byte configuration record or 
+*									CONFIG_STORE_NONE to disable (default).
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setConfigStore(unsigned int address)
+{
+	configAddress = address;
+}
+
 /*******************************************************************************
 * Name: getStatus
 * Description: WISMO228 operation status.
@@ -187,6 +495,36 @@ void	WISMO228::init()
 	
 	// Initial WISMO228 state
 	status = OFF;
+	
+#if WISMO228_GPRS
+	// No server address resolved yet
+	clearDnsCache();
+#endif
+	
+#if WISMO228_PING
+	// No ping series started yet
+	memset(&pingStats, 0, sizeof(pingStats));
+#endif
+	
+	// Signal quality monitor disabled
+	setSignalMonitor(0, MINIMUM_SIGNAL_DBM);
+	
+	// Response timeouts are learned from here on
+	resetLatency(TIMEOUT_LOCAL, MIN_TIMEOUT, MIN_TIMEOUT);
+	resetLatency(TIMEOUT_NETWORK, MED_TIMEOUT, MAX_TIMEOUT);
+	resetLatency(TIMEOUT_SOCKET, MED_TIMEOUT, MAX_TIMEOUT);
+	resetLatency(TIMEOUT_SERVER, MED_TIMEOUT, MAX_TIMEOUT);
+	
+	// Default retry policy
+	setRetryPolicy(NULL);
+	
+#if WISMO228_CLOCK
+	// Local timebase is not synchronized yet
+	timeSynced = false;
+	timeInterval = 0;
+	timeDrift = 0;
+	timeZone = 0;
+#endif
 }
 
 /*******************************************************************************
@@ -222,6 +560,13 @@ bool	WISMO228::powerUp()
 		// Configure reply timeout period
 		uart->setTimeout(MIN_TIMEOUT);
 		
+		// Module restores configuration saved in its profile on an earlier power up
+		if ((configAddress != CONFIG_STORE_NONE) && 
+				(eeprom_read_word((uint16_t *)(size_t)configAddress) == storedConfig()))
+		{
+			configShadow = CONFIG_ECHO_OFF | CONFIG_SMS;
+		}
+		
 		// Turn echo off to ease serial congestion
 		if (offEcho())
 		{
@@ -234,20 +579,25 @@ bool	WISMO228::powerUp()
 				if (registerNetwork())
 				{
           Serial.println("Network OK");
-					// Enable text mode SMS
-					if (textModeSms())
+					// Enable text mode SMS & ring pin as new SMS indicator if used
+					if (smsSetup())
 					{
             Serial.println("SMS text mode");
-						// If ring pin used as new SMS indicator
-						if (_ringPin != NC)
+						success = true;
+						
+						// Save configuration in module profile if not saved yet
+						if ((configAddress != CONFIG_STORE_NONE) && 
+								(eeprom_read_word((uint16_t *)(size_t)configAddress) != storedConfig()))
 						{
-							// Configure ring pin as new SMS indicator
-							if (newSmsSetup())
+							uart->println(F("AT&W"));
+							
+							readFlash(ok, responseBuffer);
+							
+							if (findReply(TIMEOUT_LOCAL, responseBuffer))
 							{
-								success = true;
+								eeprom_update_word((uint16_t *)(size_t)configAddress, storedConfig());
 							}
 						}
-						else	success = true;
 					}
 				}
 			}
@@ -290,6 +640,13 @@ void	WISMO228::shutdown()
 		uart->flush();
 		// WISMO228 is in shutdown mode
 		status = OFF;
+		// Configuration not saved in module profile is lost
+		configShadow = 0;
+#if WISMO228_GPRS
+		// GPRS is not restored by the link supervisor after the next power up
+		linkApn = NULL;
+		socketsOpen = 0;
+#endif
 	}
 }
 
@@ -320,7 +677,7 @@ bool	WISMO228::simReady()
 	{
 		uart->println(F("AT+CPIN?"));
 
-		if (uart->find(responseBuffer))
+		if (findReply(TIMEOUT_LOCAL, responseBuffer))
 		{
 			success = true;
 			break;
@@ -357,9 +714,19 @@ bool	WISMO228::offEcho()
 	// might be available)
 	while (timeout > millis())
 	{
-		uart->println(F("ATE0"));
-		if (uart->find(responseBuffer))
+		// Only check module is ready if echo is known to be off
+		if (configShadow & CONFIG_ECHO_OFF)
+		{
+			uart->println(F("AT"));
+		}
+		else
+		{
+			uart->println(F("ATE0"));
+		}
+		
+		if (findReply(TIMEOUT_LOCAL, responseBuffer))
 		{	
+			configShadow |= CONFIG_ECHO_OFF;
 			success = true;
 			break;
 		}
@@ -384,6 +751,7 @@ bool	WISMO228::offEcho()
 bool	WISMO228::registerNetwork()
 {
 	bool	success = false;
+	int	registration;
 	unsigned long	timeout;
 	
 	timeout = millis() + MAX_TIMEOUT;
@@ -391,11 +759,10 @@ bool	WISMO228::registerNetwork()
 	// Wait for network registeration
 	while (timeout > millis())
 	{
-		uart->println(F("AT+CREG?"));
+		registration = readRegistration(TIMEOUT_NETWORK);
 		
-		readFlash(networkOk, responseBuffer);
-
-		if (uart->find(responseBuffer))
+		// Registered to home network or roaming
+		if ((registration == 1) || (registration == 5))
 		{	
 			success = true;
 			break;
@@ -406,39 +773,59 @@ bool	WISMO228::registerNetwork()
 }
 
 /*******************************************************************************
-* Name: textModeSms
-* Description: Configure SMS module in text mode.
+* Name: readRegistration
+* Description: Retrieve the network registration state. Unsolicited 
+*							 registration changes (+CREG: <stat>) arriving before the reply 
+*							 (+CREG: <mode>,<stat>) are skipped.
 *
 * Argument  			Description
 * =========  			===========
-* 1. NIL
+* 1. type					Class of command (refer to getTimeout).
 *
 * Return					Description
 * =========				===========
-* 1. success 			Returns true if SMS text mode is successfully configured or 
-*									false if otherwise.
+* 1. registration	Registration state (1 - home network, 5 - roaming, others - 
+*									not registered) or -1 if the module does not reply.
 *
 *******************************************************************************/
-bool WISMO228::textModeSms()
+int	WISMO228::readRegistration(timeoutClass_t type)
 {
-	bool	success = false;
-		
-	// Text mode SMS
-	uart->println(F("AT+CMGF=1"));
+	int	registration = -1;
+	char	line[LINE_LENGTH_MAX];
+	char	*linePtr;
 	
-	readFlash(ok, responseBuffer);
+	uart->println(F("AT+CREG?"));
 	
-	if (uart->find(responseBuffer))
+	while (registration < 0)
 	{
-		success = true;
+		readFlash(networkStatus, responseBuffer);
+		
+		if (!findReply(type, responseBuffer))
+		{
+			break;
+		}
+		
+		readLine(line, LINE_LENGTH_MAX);
+		
+		// Only the reply carries the result code mode in front of the state
+		linePtr = strchr(line, ',');
+		
+		if (linePtr != NULL)
+		{
+			registration = atoi(linePtr + 1);
+			
+			readFlash(ok, responseBuffer);
+			uart->find(responseBuffer);
+		}
 	}
 	
-	return (success);
+	return (registration);
 }
 
 /*******************************************************************************
-* Name: newSmsSetup
-* Description: Configure new SMS notification setup.
+* Name: smsSetup
+* Description: Configure SMS module in text mode and new SMS notification 
+*							 setup if RING pin is used, with a single command line.
 *
 * Argument  			Description
 * =========  			===========
@@ -446,21 +833,33 @@ bool WISMO228::textModeSms()
 *
 * Return					Description
 * =========				===========
-* 1. success 			Returns true if DTR pin is successfully configured as new
-*									SMS indication or false if otherwise.
+* 1. success 			Returns true if SMS text mode (and DTR pin as new SMS 
+*									indication) is successfully configured or false if otherwise.
 *
 *******************************************************************************/
-bool WISMO228::newSmsSetup()
+bool WISMO228::smsSetup()
 {
 	bool	success = false;
 	
-	// User RING pin (falling edge) as new message indication
-	uart->println(F("AT+PSRIC=2,0"));
-	
-	readFlash(ok, responseBuffer);
+	// Skip if already configured
+	if (!(configShadow & CONFIG_SMS))
+	{
+		// Text mode SMS
+		queueCommand(F("+CMGF=1"), NULL);
+		
+		if (_ringPin != NC)
+		{
+			// User RING pin (falling edge) as new message indication
+			queueCommand(F("+PSRIC=2,0"), NULL);
+		}
+	}
 	
-	if (uart->find(responseBuffer))
+	if ((commandCount == 0) || sendQueue(true))
 	{
+		configShadow |= CONFIG_SMS;
+		
+		if (_ringPin != NC)
+		{
     #if defined __AVR_ATmega32U4__
       if (_ringPin == 2)
       {
@@ -477,7 +876,7 @@ bool WISMO228::newSmsSetup()
     	// Attach interrupt for RING pin as new SMS indicator
 		  attachInterrupt((_ringPin - 2), functionPtr, FALLING); 
     #endif
-
+		}
 
 		success = true;
 	}
@@ -485,6 +884,7 @@ bool WISMO228::newSmsSetup()
 	return (success);
 }
 
+#if WISMO228_SMS
 /*******************************************************************************
 * Name: sendSms
 * Description: Send SMS.
@@ -514,47 +914,102 @@ bool	WISMO228::sendSms(const char *recipient, const char *message)
 		// If SMS length is less than 160 characters
 		if (strlen(message) <= SMS_LENGTH_MAX)
 		{
-			uart->print(F("AT+CMGS=\""));
-			uart->print(recipient);
-			uart->println(F("\""));
+			success = submitSms(recipient, message);
+		}
+	}
+	return (success);	
+}
+
+/*******************************************************************************
+* Name: sendSms
+* Description: Send the same SMS to several recipients, keeping the SMS relay 
+*							 link open between submissions (AT+CMMS) so that each 
+*							 submission follows the previous one immediately.
+*
+* Argument  			Description
+* =========  			===========
+* 1. recipients   Array of phone numbers of the recipients.
+*
+* 2. recipientCount	Number of recipients.
+*
+* 3. message			Message of length not more than 160 characters.		
+*
+*	4. results			Array of recipientCount entries set to true for each 
+*									recipient the SMS is successfully sent to or NULL if not 
+*									required.
+*
+* Return					Description
+* =========				===========
+* 1. count	 			Number of recipients the SMS is successfully sent to.
+*
+*******************************************************************************/		
+unsigned char	WISMO228::sendSms(const char * const *recipients, 
+																unsigned char recipientCount, 
+																const char *message, bool *results)
+{
+	unsigned	char	count = 0;
+	unsigned	char	index;
+	unsigned	long	start;
+	bool	sent;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If WISMO228 is powered on
+	if ((status == ON) && (strlen(message) <= SMS_LENGTH_MAX))
+	{
+		start = millis();
+		
+		// Keep SMS relay link open between submissions, failure only costs speed
+		uart->println(F("AT+CMMS=1"));
+		
+		readFlash(ok, responseBuffer);
+		
+		findReply(TIMEOUT_LOCAL, responseBuffer);
+		
+		for (index = 0; index < recipientCount; index++)
+		{
+			sent = submitSms(recipients[index], message);
 			
-			// Writing SMS takes more time compared to other task
-			uart->setTimeout(MED_TIMEOUT);
+			if (sent)	count++;
 			
-			readFlash(smsCursor, responseBuffer);
-      
-			// Wait for SMS writing prompt (cursor)
-			if (uart->find(responseBuffer))
+			if (results != NULL)
 			{
-				// Write the message
-				uart->print(message);
-				// End the message
-				uart->write(26);
-				
-				readFlash(smsSendOk, responseBuffer);
-				
-				if (uart->find(responseBuffer))
-				{
-					// Revert back to normal reply timeout
-					uart->setTimeout(MIN_TIMEOUT);
-					
-					if (waitForReply(3, MIN_TIMEOUT))
-					{
-						// Read out all SMS ID
-						while ((char)uart->read() != '\r');
-						
-						readFlash(ok, responseBuffer);
-						
-						if (uart->find(responseBuffer))
-						{
-							success = true;
-						}
-					}
-				}
+				results[index] = sent;
 			}
 		}
+		
+		// Release the SMS relay link
+		uart->println(F("AT+CMMS=0"));
+		
+		readFlash(ok, responseBuffer);
+		
+		findReply(TIMEOUT_LOCAL, responseBuffer);
+		
+		// Messages per minute
+		start = millis() - start;
+		smsRate = (start > 0) ? ((count * 60000UL) / start) : 0;
 	}
-	return (success);	
+	
+	return (count);
+}
+
+/*******************************************************************************
+* Name: getSmsRate
+* Description: Throughput of the last SMS sent to several recipients.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. rate					Messages sent per minute.
+*
+*******************************************************************************/		
+unsigned int	WISMO228::getSmsRate()
+{
+	return (smsRate);
 }
 
 /*******************************************************************************
@@ -570,15 +1025,18 @@ bool	WISMO228::sendSms(const char *recipient, const char *message)
 * Return					Description
 * =========				===========
 * 1. success 			Returns true if new SMS retrieval is successfully or false if 
-*									otherwise.
+*									otherwise. SMS from a sender not in the whitelist (refer to 
+*									setWhitelist) is deleted and false is returned.
 *
 *******************************************************************************/
 bool WISMO228::readSms(char *sender, char *message)
 {
 	bool success = false;
+	bool	allowed;
 	unsigned	char	rxCount;
 	char	index[4];
 	char	*indexPtr;
+	char	*senderPtr = sender;
 	char	rxByte;
 	
 	// Revert to minimum response time	
@@ -627,6 +1085,9 @@ bool WISMO228::readSms(char *sender, char *message)
 					// Terminate the sender string
 					*sender = '\0';
 					
+					// Message from unauthorised sender is deleted without being read
+					allowed = (whitelistSlots == 0) || (findSender(senderPtr) >= 0);
+					
 					readFlash(commaQuoteMark, responseBuffer);
 
 					if (uart->find(responseBuffer))
@@ -667,7 +1128,7 @@ bool WISMO228::readSms(char *sender, char *message)
 											while (rxByte != '\r')
 											{
 												// Save SMS message
-												*message++ = rxByte;
+												if (allowed)	*message++ = rxByte;
 												// We are running faster than incoming data
 												while (!uart->available());
 												rxByte = uart->read();
@@ -685,7 +1146,13 @@ bool WISMO228::readSms(char *sender, char *message)
 								
 												if (uart->find(responseBuffer))
 												{
-													success = true;
+													success = allowed;
+													
+													// Make room before the storage is full
+													if (smsCleanup > 0)
+													{
+														cleanupSms();
+													}
 												}
 											}
 										}
@@ -703,406 +1170,214 @@ bool WISMO228::readSms(char *sender, char *message)
 }
 
 /*******************************************************************************
-* Name: openGPRS
-* Description: Get the WISMO228 to connect to the GPRS network.
+* Name: setWhitelist
+* Description: Configure the authorised sender whitelist stored in EEPROM as 
+*							 hashes of the sender phone numbers (open addressing, linear 
+*							 probing). When enabled, readSms deletes SMS from senders not in
+*							 the whitelist without retrieving their content.
 *
 * Argument  			Description
 * =========  			===========
-* 1. apn     			Access Point Name (APN) of the IP Packet Data Network (PDN) 
-*									that you want to connect to.
+* 1. address			EEPROM address of the whitelist.
 *
-* 2. username			Username of the APN you are connecting to. If no username is
-*									is required, use the " " to indicate this.
+* 2. slots				Number of 4 byte slots in the whitelist or 0 to disable. Keep
+*									some slots free for fast lookup.
 *
-* 3. password			Password of corresponding username. If no password is required,
-*									use the " " string to indicate this.		
+* Return					Description
+* =========				===========
+* 1. NIL
 *
 *******************************************************************************/
-bool WISMO228::openGPRS(const char *apn, const char *username, 
-												const char *password)
+void	WISMO228::setWhitelist(unsigned int address, unsigned char slots)
 {
-	bool success = false;
-	unsigned char attempt;
-	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
-	
-	if (status == ON)
-	{
-		// Start TCP/IP stack
-		uart->println(F("AT+WIPCFG=1"));
-		
-		readFlash(ok, responseBuffer);
-
-		if (uart->find(responseBuffer))
-		{
-			// Open GPRS bearer
-			uart->println(F("AT+WIPBR=1,6"));
-			
-			if (uart->find(responseBuffer))
-			{
-				// Set the APN
-				uart->print(F("AT+WIPBR=2,6,11,\""));
-				uart->print(apn);
-				uart->println(F("\""));
-				
-				if (uart->find(responseBuffer))
-				{
-					// Set the username
-					uart->print(F("AT+WIPBR=2,6,0,\""));
-					uart->print(username);
-					uart->println(F("\""));
-					
-					if (uart->find(responseBuffer))
-					{
-						// Set the password
-						uart->print(F("AT+WIPBR=2,6,1,\""));
-						uart->print(password);
-						uart->println(F("\""));
-						
-						if (uart->find(responseBuffer))
-						{
-							// It takes slightly longer to start GPRS bearer 	
-							uart->setTimeout(MED_TIMEOUT);						
-							delay(1000);
-							// Maximum 3 attempt to connect to GPRS as base station might not
-              // have enough time slots for GPRS as voice call is given priority
-							for (attempt = 3; attempt > 0; attempt--)
-							{
-								// Start GPRS bearer
-								uart->println(F("AT+WIPBR=4,6,0"));
-							
-								if (uart->find(responseBuffer))
-								{
-									// GPRS connection is up
-									status = GPRS_ON;
-									success = true;
-									break;
-								}
-							}
-						}
-					}
-				}
-			}
-		}
-	}
-	
-	return (success);
+	whitelistAddress = address;
+	whitelistSlots = slots;
 }
 
 /*******************************************************************************
-* Name: closeGPRS
-* Description: Get the WISMO228 to disconnect from the GPRS network.
+* Name: clearWhitelist
+* Description: Remove all senders from the whitelist.
 *
 * Argument  			Description
 * =========  			===========
-* 1. NIL	
+* 1. NIL
 *
 * Return					Description
 * =========				===========
-* 1. success 			Returns true if successfully disconnected from GPRS network or
-*								  false if otherwise.
+* 1. NIL
 *
 *******************************************************************************/
-bool WISMO228::closeGPRS()
+void	WISMO228::clearWhitelist()
 {
-	bool success = false;
-	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
+	unsigned	char	slot;
 	
-	// Only close GPRS connection if currently on
-	if (status == GPRS_ON)
+	for (slot = 0; slot < whitelistSlots; slot++)
 	{
-		// Stop TCP/IP stack (automatically detach from GPRS)
-		uart->println(F("AT+WIPCFG=0"));
-		
-		readFlash(ok, responseBuffer);
-		
-		if (uart->find(responseBuffer))
-		{
-			// Revert to on mode
-			status = ON;
-			success = true;
-		}	
+		eeprom_update_dword(whitelistSlot(slot), WHITELIST_EMPTY);
 	}
-	
-	return (success);
 }
 
 /*******************************************************************************
-* Name: ping
-* Description: Ping a server.
+* Name: addSender
+* Description: Add a sender to the whitelist.
 *
 * Argument  			Description
 * =========  			===========
-* 1. url     			URL of the server to ping.
-*									Example: www.google.com, 200.200.200.200
-*	
+* 1. sender				Phone number of the sender with or without the "+" prefix.
+*
 * Return					Description
 * =========				===========
-* 1. responseTime The response time of ping in ms. If no response from the 
-*									server or timeout occurs, a value of 0 is return.
+* 1. success 			Returns true if the sender is in the whitelist or false if 
+*									the whitelist is full or not enabled.
 *
 *******************************************************************************/
-unsigned int	WISMO228::ping(const char	*url)
-{	
-	// Ping response time
-	unsigned int	responseTime = 0;
-	char	responseTimeStr[RESPONSE_TIME_MAX];
-	char	*responseTimeStrPtr;
-	char	rxByte;
+bool	WISMO228::addSender(const char *sender)
+{
+	bool	success = false;
+	uint32_t	hash;
+	uint32_t	entry;
+	unsigned	char	slot;
+	unsigned	char	vacant = NC;
+	unsigned	char	probe;
 	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
+	hash = senderHash(sender);
 	
-	// Needs GPRS connection to execute ping
-	if (status == GPRS_ON)
+	for (probe = 0; probe < whitelistSlots; probe++)
 	{
-		// Execute the PING service
-		uart->print(F("AT+WIPPING=\""));
-		uart->print(url);
-		uart->println(F("\""));
-
-		readFlash(pingOk, responseBuffer);
-
-		// If ping is successful
-		if (uart->find(responseBuffer))
+		slot = (hash + probe) % whitelistSlots;
+		entry = eeprom_read_dword(whitelistSlot(slot));
+		
+		if (entry == hash)
 		{
-			// Initialize string of response time array
-			responseTimeStrPtr = responseTimeStr;
-				
-			do
-			{
-				while (!uart->available());
-				rxByte = uart->read();
-				*responseTimeStrPtr++ = rxByte;
-			}	while (rxByte != '\r');
-					
-			// Terminate the string
-			*responseTimeStrPtr = '\0';
-				
-			readFlash(lineFeed, responseBuffer);	
-	
-			if (uart->find(responseBuffer))
-			{
-				// Convert port number into string
-				sscanf(responseTimeStr, "%u", &responseTime);
-			}
+			// Already in the whitelist
+			success = true;
+			break;
 		}
+		
+		// Reuse the first removed or empty slot
+		if ((vacant == NC) && 
+				((entry == WHITELIST_REMOVED) || (entry == WHITELIST_EMPTY)))
+		{
+			vacant = slot;
+		}
+		
+		// Sender cannot be further down the probe sequence
+		if (entry == WHITELIST_EMPTY)	break;
 	}
 	
-	return(responseTime);
+	if (!success && (vacant != NC))
+	{
+		eeprom_update_dword(whitelistSlot(vacant), hash);
+		success = true;
+	}
+	
+	return (success);
 }
 
 /*******************************************************************************
-* Name: getHttp
-* Description: Perform HTTP method GET to retrieve or send data to a server.
+* Name: removeSender
+* Description: Remove a sender from the whitelist.
 *
 * Argument  			Description
 * =========  			===========
-* 1. url     			URL of the server.
-*									Example: www.google.com, 200.200.200.200
-*
-* 2. path					The path or directory to access in the server. 
-*									Examples: 
-*									"/" - No directory is required.
-*									"/directory/subdirectory" - Directory is required.
-*									"/script.php?data=value" - For sending data to server.
+* 1. sender				Phone number of the sender with or without the "+" prefix.
 *
-*	3. port					Server TCP port number from 0-65535.
-*
-*	4. *message			Location to store the data retrieved from the server.
-*
-*	5. limit				The maximum length of data to received from the server. 
-*	
 * Return					Description
 * =========				===========
-* 1. success 			Returns true if the procedure is successful and false if 
-*									otherwise.
+* 1. success 			Returns true if the sender is removed or false if it is not 
+*									in the whitelist.
 *
 *******************************************************************************/
-bool	WISMO228::getHttp(const char *server, const char *path, const char	*port, 
-												char *message, unsigned int limit)
+bool	WISMO228::removeSender(const char *sender)
 {
-	unsigned long timeout;
-	char	rxByte;
 	bool	success = false;
+	int	slot;
 	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
+	slot = findSender(sender);
 	
-	// If currently attach to GPRS
-	if (status == GPRS_ON)
+	if (slot >= 0)
 	{
-		if (openPort(server, port))
-		{			
-			if (exchangeData())
-			{
-				uart->print(F("GET "));
-				uart->print(path);
-				uart->print(F(" HTTP/1.1\r\nHost: "));
-				uart->print(server);
-				uart->println(F("\r\n"));
-				
-				timeout = millis() + 3000;
-				
-				while ((limit > 0) && (millis() < timeout))
-				{
-					if (uart->available())
-					{
-						*message++ = uart->read();
-						limit--;
-					}
-				}
-
-				delay(3000);
-				
-				// Revert back to AT command mode
-				uart->print(F("+++"));
-				
-				// Expecting an "OK" response
-				readFlash(ok, responseBuffer);
-				
-				if (uart->find(responseBuffer))
-				{								
-					// Close the TCP socket with server
-					uart->println(F("AT+WIPCLOSE=2,1"));
-					
-					// Expecting an "OK" response
-					if (uart->find(responseBuffer))
-					{
-						success = true;
-					}
-				}
-			}
-		}
+		// Keep the probe sequence of other senders intact
+		eeprom_update_dword(whitelistSlot(slot), WHITELIST_REMOVED);
+		success = true;
 	}
 	
 	return (success);
 }
 
 /*******************************************************************************
-* Name: putHttp
-* Description: Perform HTTP method PUT to send data to a server.
+* Name: dispatchSms
+* Description: Route a SMS to the handler of the command it starts with. The 
+*							 first word of the message is the command keyword (case 
+*							 insensitive) and the rest are the arguments. Commands are looked
+*							 up by binary search in a table stored in flash memory.
 *
 * Argument  			Description
 * =========  			===========
-* 1. server     	URL of the server.
-*									Example: www.google.com, 200.200.200.200
-*
-* 2. path					The path or directory to access in the server. 
-*									Examples: 
-*									"/" - No directory is required.
-*									"/directory/subdirectory" - Directory is required.
-*									"/script.php?data=value" - For sending data to server.
+* 1. table				Command table stored in flash memory (PROGMEM), sorted by 
+*									keyword in ascending order of character codes (strcmp). 
+*									Keywords are in upper case and also stored in flash memory.
 *
-*	3. port					Server TCP port number from 0-65535.
+* 2. count				Number of commands in the table.
 *
-*	4. host					Host of the residing end application. Typically same as the 
-*									server.
+*	3. sender				Sender of the SMS, passed to the handler.
 *
-*	5. data				  Data in the following format:
-*									dataName1,value\r\ndataName2,value\r\n
-*									Each line consist of a data name separated by a comma and it's
-*									corresponding value. The new line feed is required for each
-*									data entry.
-*	6. controlKey		Control key name and it's value which is specified by the 
-*									server hosting the application in the following format:
-*									ControlKeyName: Value					 
+*	4. message			Content of the SMS. The keyword is terminated in place.
 *
-* 7. contentType	Type of content which is being sent over.
-*	
 * Return					Description
 * =========				===========
-* 1. success 			Returns true if the procedure is successful and false if 
-*									otherwise.	
+* 1. success 			Returns true if a command handler is called or false if the 
+*									message does not start with a known command.
 *
 *******************************************************************************/
-bool	WISMO228::putHttp(const char *server, const char *path, const char *port, 
-              const char *host, const char *data, const char *controlKey, 
-							const char *contentType)
+bool	WISMO228::dispatchSms(const smsCommand_t *table, unsigned char count, 
+															const char *sender, char *message)
 {
 	bool	success = false;
+	char	*arguments;
+	int	low = 0;
+	int	high = count - 1;
+	int	middle;
+	int	order;
+	smsHandler_t	handler;
 	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
+	// Skip leading spaces
+	while (*message == ' ')	message++;
 	
-	// If currently attach to GPRS
-	if (status == GPRS_ON)
+	// Separate the keyword from the arguments
+	arguments = strchr(message, ' ');
+	
+	if (arguments != NULL)
 	{
-		// Open a port with remote server	
-		if (openPort(server, port))
-		{		
-			// Enter transparent data mode
-			if (exchangeData())
-			{
-				uart->print(F("PUT "));
-				uart->print(path);
-				uart->println(F(" HTTP/1.1"));
-				uart->print(F("Host: "));
-				uart->println(host);
-				uart->println(controlKey);
-				uart->print(F("Content-Length: "));
-				uart->println(strlen(data));
-				uart->print(F("Content-Type: "));
-				uart->println(contentType);
-				uart->println(F("Connection: close"));
-				uart->println();
-				uart->print(data);
-				uart->print("\n");
-				
-				// If you need to retrieve the whole response from the remote server,
-				// retrieve the response starting from here
-				
-				// It takes more time for server to response to a PUT request	
-				uart->setTimeout(MED_TIMEOUT);
-				// Expecting an OK from remote server
-				readFlash(ok, responseBuffer);
-				
-				// If HTTP PUT request successful
-				if (uart->find(responseBuffer))
-				{
-					// Expecting a SHUTDOWN signal from remote server
-					readFlash(shutdownLink, responseBuffer);
-					
-					if (uart->find(responseBuffer))
-					{
-						// PUT request completed
-						success = true;
-					}
-				}
-				// Revert back to normal reply timeout
-				uart->setTimeout(MIN_TIMEOUT);
-						
-				// Revert back to AT command mode
-				uart->print(F("+++"));
-				
-				// Expecting an OK from remote server
-				readFlash(ok, responseBuffer);
-						
-				if (uart->find(responseBuffer))
-				{
-					// Close the TCP socket with server
-					uart->println(F("AT+WIPCLOSE=2,1"));
-					
-					// Expecting an "OK" response
-					if (uart->find(responseBuffer))
-					{
-						// Port properly closed
-					}
-				}
-			}
-			else
-			{
-				uart->println(F("AT+WIPCLOSE=2,1"));
-				
-				// Expecting an "OK" response
-				if (uart->find(responseBuffer))
-				{
-					// Port properly closed
-				}
-			}	
+		*arguments++ = '\0';
+		while (*arguments == ' ')	arguments++;
+	}
+	else
+	{
+		arguments = message + strlen(message);
+	}
+	
+	while (low <= high)
+	{
+		middle = (low + high) / 2;
+		
+		order = compareKeyword(message, 
+													 (const char *)pgm_read_word(&table[middle].keyword));
+		
+		if (order == 0)
+		{
+			handler = (smsHandler_t)pgm_read_word(&table[middle].handler);
+			handler(sender, arguments);
+			success = true;
+			break;
+		}
+		else if (order < 0)
+		{
+			high = middle - 1;
+		}
+		else
+		{
+			low = middle + 1;
 		}
 	}
 	
@@ -1110,509 +1385,5728 @@ bool	WISMO228::putHttp(const char *server, const char *path, const char *port,
 }
 
 /*******************************************************************************
-* Name: sendEmail
-* Description: Send an email through SMTP server.
+* Name: compareKeyword
+* Description: Compare a word with a command keyword. The word is folded to 
+*							 upper case, so the order agrees with a table of upper case 
+*							 keywords sorted by character code, including the characters 
+*							 between 'Z' & 'a'.
 *
 * Argument  			Description
 * =========  			===========
-* 1. smtpServer   SMTP server name.
-*									Example: mail.yourdomain.com
+* 1. word					Word in RAM, in any case.
 *
-* 2. port					SMTP port number. Usually is 25.
+*	2. keyword			Upper case keyword stored in flash memory.
 *
-*	3. username			Complete username (email address).
-*									Example: user@yourdomain.com
+* Return					Description
+* =========				===========
+* 1. order				Negative, 0 or positive if the word is ordered before, equal to
+*									or after the keyword.
 *
-*	4. password			Corresponding password for the username.
+*******************************************************************************/
+int	WISMO228::compareKeyword(const char *word, const char *keyword)
+{
+	unsigned char	wordChar;
+	unsigned char	keywordChar;
+	
+	do
+	{
+		wordChar = toupper((unsigned char)*word++);
+		keywordChar = pgm_read_byte(keyword++);
+	} while ((wordChar == keywordChar) && (wordChar != '\0'));
+	
+	return (wordChar - keywordChar);
+}
+
+/*******************************************************************************
+* Name: processSms
+* Description: Read 1 new SMS and route it to its command handler (refer to 
+*							 dispatchSms).
 *
-*	5. recipient		Recipient email address.
-*									Example: recipient@somedomain.com
+* Argument  			Description
+* =========  			===========
+* 1. table				Command table stored in flash memory (PROGMEM), sorted by 
+*									keyword in ascending order.
 *
-*	6. title				Title or subject of the email.
-*									Example: Hello World!
+* 2. count				Number of commands in the table.
 *
-*	7. message			Content of the email.
-*	
 * Return					Description
 * =========				===========
-* 1. success 			Returns true if the procedure is successful and false if 
-*									otherwise.
+* 1. success 			Returns true if a new SMS is read and its command handler is 
+*									called or false if otherwise.
 *
-*******************************************************************************/	
-bool WISMO228::sendEmail(const char *smtpServer, const char *port, 
-												 const char *username, const char *password, 
-												 const char *recipient, const char *title, 
-												 const char *content)
+*******************************************************************************/
+bool	WISMO228::processSms(const smsCommand_t *table, unsigned char count)
 {
 	bool	success = false;
-	char	rxByte;
-	char	dataCountStr[5];
-	char	*dataCountStrPtr;
-	char	base64[50];
-	unsigned	int	dataCount;
-	//unsigned long	timeout;
-	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
+	char	sender[SENDER_LENGTH_MAX];
+	char	message[SMS_LENGTH_MAX + 1];
 	
-	// If currently attach to GPRS
-	if (status == GPRS_ON)
+	if (readSms(sender, message))
 	{
-		// Clear any unwanted data in UART
-		uart->flush();
-		
-		if (openPort(smtpServer, port))
-		{
-			readFlash(dataOk, responseBuffer);
-			
-			// Retrieving data from web takes longer time
-			uart->setTimeout(MAX_TIMEOUT);
+		success = dispatchSms(table, count, sender, message);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: getSmsStorage
+* Description: Retrieve occupancy of the SMS storage.
+*
+* Argument  			Description
+* =========  			===========
+* 1. used					Number of messages in the storage.
+*
+* 2. total				Number of messages the storage can hold.
+*
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if occupancy is retrieved successfully or false 
+*									if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::getSmsStorage(unsigned char *used, unsigned char *total)
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == ON)
+	{
+		uart->println(F("AT+CPMS?"));
+		
+		// Reply: +CPMS: "SM",<used>,<total>,"SM",<used>,<total>,...
+		readFlash(smsStorage, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			readFlash(quoteMark, responseBuffer);
 			
 			if (uart->find(responseBuffer))
 			{
-				dataCountStrPtr = dataCountStr;
-				
-				do
-				{
-					while (!uart->available());
-					rxByte = uart->read();
-					*dataCountStrPtr++ = rxByte;
-				} while (rxByte != '\r');
+				*used = uart->parseInt();
+				*total = uart->parseInt();
 				
-				// Terminate the string
-				*dataCountStrPtr = '\0';
-				
-				// Convert data count into unsigned integer
-				sscanf(dataCountStr, "%u", &dataCount);
-
-				uart->setTimeout(MIN_TIMEOUT);
-				
-				readFlash(lineFeed, responseBuffer);
+				readFlash(ok, responseBuffer);
 				
 				if (uart->find(responseBuffer))
-				{			
-					if (exchangeData())
-					{
-						for (dataCount; dataCount > 0; dataCount--)
-						{
-							// We are running at the speed of light!
-							while (!uart->available());
-							// Pull out the server messages
-							rxByte = uart->read();
-						}
-						// Start communicating with server using extended SMTP protocol
-						uart->print(F("EHLO "));
-						uart->println(smtpServer);
-						
-						delay (5000);
-
-						uart->flush();
-				
-						// Initiate account login
-						uart->println(F("AUTH LOGIN"));
-						
-						// Retrieve string of username prompt in base 64 format from flash
-						readFlash(smtpUsernamePrompt, responseBuffer);
-							
-						// If receive the username prompt in base 64 format
-						if (uart->find(responseBuffer))
-						{
-							// Encode username into base 64 format
-							encodeBase64(username, base64);
-							// Send username in base 64 format
-							uart->println(base64);
-							
-							// Retrieve string of password prompt in base 64 format from flash
-							readFlash(smtpPasswordPrompt, responseBuffer);
-							
-							// If receive the password prompt in base 64 format
-							if (uart->find(responseBuffer))
-							{
-								// Encode username into base 64 format
-								encodeBase64(password, base64);		
-								// Send password in base 64 format
-								uart->println(base64);
-								
-								// Retrieve string of authentication success in base 64 format 
-								// from flash
-								readFlash(smtpAuthenticationOk, responseBuffer);
-								
-								// If receive authentication success
-								if (uart->find(responseBuffer))
-								{
-									// Email sender
-									uart->print(F("MAIL FROM: <"));
-									uart->print(username);
-									uart->println(F(">"));
-									
-									readFlash(smtpOk, responseBuffer);
-									
-									// If sender ok
-									if (uart->find(responseBuffer))
-									{
-										// Email recipient
-										uart->print(F("RCPT TO: <"));
-										uart->print(recipient);
-										uart->println(F(">"));
-										
-										readFlash(smtpOk, responseBuffer);
-										
-										// If recipient ok
-										if (uart->find(responseBuffer))
-										{
-											// Start of email body
-											uart->println(F("DATA"));
-											
-											readFlash(smtpInputPrompt, responseBuffer);
-											
-											// If receive start email input prompt
-											if (uart->find(responseBuffer))
-											{
-												// Remaining data consists of email input instruction 
-												do
-												{
-													// We are running at the speed of light!
-													while (!uart->available());
-													// Read until end of line is found
-													rxByte = uart->read();
-												} while (rxByte != '\n');
-											
-												// Email header
-												uart->print(F("From: "));
-												uart->println(username);
-												uart->print(F("To: "));
-												uart->println(recipient);
-												uart->print(F("Subject: "));
-												uart->println(title);
-												uart->print(F("\r\n"));
-												// Email message
-												uart->print(content);
-												uart->print(F("\r\n.\r\n"));
-												
-												readFlash(smtpOk, responseBuffer);
-												
-												// Email successfully sent
-												if (uart->find(responseBuffer))
-												{
-													// Remaining data consists of incomprehensible 
-													// email sent ID
-													do
-													{
-														// We are running at the speed of light!
-														while (!uart->available());
-														// Read until end of line is found
-														rxByte = uart->read();
-													} while (rxByte != '\n');
-													
-													// WISMO228 gets exhausted after sending an email
-													// Give him a short break
-													delay(1000);
-													// Revert to AT command mode
-													uart->print(F("+++"));
-													
-													readFlash(ok, responseBuffer);
-													
-													// Data mode exited successfully
-													if (uart->find(responseBuffer))
-													{
-														// Close the TCP socket
-														uart->println(F("AT+WIPCLOSE=2,1"));
-										
-														if (uart->find(responseBuffer))
-														{
-															success = true;
-														}	
-													}
-												}
-											}
-										}
-									}	
-								}
-							}	
-						}	
-					}
+				{
+					success = true;
 				}
 			}
 		}
 	}
 	
-	return (success);	
+	return (success);
 }
 
 /*******************************************************************************
-* Name: getClock
-* Description: Retrieve the WISMO228 module clock.
+* Name: selectSmsStorage
+* Description: Select the module memory ("ME") to read, write & receive SMS if
+*							 the module offers it, as it is faster to access and holds more 
+*							 messages than the SIM card. SIM card storage is kept otherwise.
 *
 * Argument  			Description
 * =========  			===========
-* 1. clock     		Clock in YY/MM/DD,HH:MM:SS*ZZ format
-*									ZZ represent time difference between local & GMT time 
-*									expressed in quarters of an hour. *ZZ has a range of 
-*									-48 to +48. 
-*									Example: 11/11/16,00:56:24+32 (GMT+8 local time).
-*	
+* 1. NIL
+*
 * Return					Description
 * =========				===========
-* 1. success 			True if clock is retrieved successfully or false if otherwise. 
+* 1. success 			Returns true if module memory is selected or false if 
+*									otherwise.
 *
 *******************************************************************************/
-bool WISMO228::getClock(char *clock)
+bool	WISMO228::selectSmsStorage()
 {
-	bool success = false;
-	unsigned	char	clockCount;
+	bool	success = false;
+	char	terminator[3];
 	
 	// Revert to minimum response time	
 	uart->setTimeout(MIN_TIMEOUT);
 	
-	// If WISMO228 is on
 	if (status == ON)
 	{
-		// Request current clock
-		uart->println(F("AT+CCLK?"));
+		// Supported storages
+		uart->println(F("AT+CPMS=?"));
 		
-		readFlash(clockOk, responseBuffer);
+		readFlash(moduleStorage, responseBuffer);
+		readFlash(ok, terminator);
 		
-		if (uart->find(responseBuffer))
+		if (uart->findUntil(responseBuffer, terminator))
 		{
-			if (waitForReply(CLOCK_COUNT_MAX, MIN_TIMEOUT))
+			// Skip the rest of the list
+			uart->find(terminator);
+			
+			uart->println(F("AT+CPMS=\"ME\",\"ME\",\"ME\""));
+			
+			if (uart->find(terminator))
 			{
-				for (clockCount = CLOCK_COUNT_MAX; clockCount > 0; clockCount--)
-				{
-					// Retrieve clock
-					*clock++ = uart->read();
-				}
-				
-				// Terminate the clock string
-				*clock = '\0';
-				
-				// Expecting an "OK" response
-				readFlash(ok, responseBuffer);
-				
-				if (uart->find(responseBuffer))
+				success = true;
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: setSmsCleanup
+* Description: Configure proactive cleanup of the SMS storage. Whenever readSms 
+*							 retrieves a message and the storage occupancy is at or above 
+*							 the threshold, read & sent messages are deleted (AT+CMGD=1,3) 
+*							 so that new messages are not rejected. Unread messages are kept.
+*
+* Argument  			Description
+* =========  			===========
+* 1. threshold		Occupancy in percent (1-100) or 0 to disable.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setSmsCleanup(unsigned char threshold)
+{
+	smsCleanup = threshold;
+}
+#endif
+
+#if WISMO228_GPRS
+/*******************************************************************************
+* Name: openGPRS
+* Description: Get the WISMO228 to connect to the GPRS network. If the link 
+*							 supervisor is enabled (setLinkSupervisor), the connection is 
+*							 restored by poll whenever it is lost until closeGPRS is called.
+*
+* Argument  			Description
+* =========  			===========
+* 1. apn     			Access Point Name (APN) of the IP Packet Data Network (PDN) 
+*									that you want to connect to.
+*
+* 2. username			Username of the APN you are connecting to. If no username is
+*									is required, use the " " to indicate this.
+*
+* 3. password			Password of corresponding username. If no password is required,
+*									use the " " string to indicate this.		
+*
+* The strings must remain valid while the link supervisor is enabled.
+*
+*******************************************************************************/
+bool WISMO228::openGPRS(const char *apn, const char *username, 
+												const char *password)
+{
+	bool success = false;
+	unsigned char attempt;
+	unsigned long start;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == ON)
+	{
+		if (configureBearer(apn, username, password))
+		{
+			delay(1000);
+			start = millis();
+			
+			// Retry connecting to GPRS as base station might not have enough time 
+			// slots for GPRS as voice call is given priority
+			for (attempt = 1; ; attempt++)
+			{
+				if (startBearer())
 				{
 					success = true;
+					break;
 				}
+				
+				if (!retryWait(attempt, start))	break;
 			}
 		}
+		
+		if (success)
+		{
+			// Connection to be kept up by the link supervisor
+			linkApn = apn;
+			linkUsername = username;
+			linkPassword = password;
+			linkAttempts = 0;
+			linkPeriod = linkInterval;
+			linkChecked = millis();
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: closeGPRS
+* Description: Get the WISMO228 to disconnect from the GPRS network.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL	
+*
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if successfully disconnected from GPRS network or
+*								  false if otherwise.
+*
+*******************************************************************************/
+bool WISMO228::closeGPRS()
+{
+	bool success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// Only close GPRS connection if currently on
+	if (status == GPRS_ON)
+	{
+		// Stop TCP/IP stack (automatically detach from GPRS)
+		uart->println(F("AT+WIPCFG=0"));
+		
+		readFlash(ok, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			// Revert to on mode
+			status = ON;
+			success = true;
+			// Bearer configuration is lost with the TCP/IP stack
+			configShadow &= ~(CONFIG_STACK | CONFIG_BEARER | CONFIG_APN);
+			// Connection is no longer supervised
+			linkApn = NULL;
+			// Sockets are closed with the TCP/IP stack
+			socketsOpen = 0;
+			stopRegistrationReport();
+		}	
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: setLinkSupervisor
+* Description: Configure the background GPRS link supervisor. When enabled, 
+*							 poll checks network registration & GPRS bearer periodically 
+*							 and on registration changes reported by the module. A lost 
+*							 connection changes the status to ON and is restored in the 
+*							 background within the attempts of the retry policy.
+*
+* Argument  			Description
+* =========  			===========
+* 1. interval			Check interval in ms. 0 disables the supervisor.
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setLinkSupervisor(unsigned long interval)
+{
+	linkInterval = interval;
+	linkAttempts = 0;
+	linkPeriod = interval;
+	linkChecked = millis();
+	
+	if ((interval == 0) && (status != OFF))
+	{
+		// Revert to minimum response time	
+		uart->setTimeout(MIN_TIMEOUT);
+		
+		stopRegistrationReport();
+	}
+}
+
+/*******************************************************************************
+* Name: getLinkDrops
+* Description: Number of GPRS connection losses detected by the link supervisor.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. drops				Connection losses since the library is initialized.
+*
+*******************************************************************************/
+unsigned int	WISMO228::getLinkDrops()
+{
+	return (linkDrops);
+}
+#endif
+
+#if WISMO228_PING
+/*******************************************************************************
+* Name: ping
+* Description: Ping a server.
+*
+* Argument  			Description
+* =========  			===========
+* 1. url     			URL of the server to ping.
+*									Example: www.google.com, 200.200.200.200
+*	
+* Return					Description
+* =========				===========
+* 1. responseTime The response time of ping in ms. If no response from the 
+*									server or timeout occurs, a value of 0 is return.
+*
+*******************************************************************************/
+unsigned int	WISMO228::ping(const char	*url)
+{	
+	// Ping response time
+	unsigned int	responseTime = 0;
+	char	responseTimeStr[RESPONSE_TIME_MAX];
+	char	*responseTimeStrPtr;
+	char	rxByte;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// Needs GPRS connection to execute ping
+	if (status == GPRS_ON)
+	{
+		// Execute the PING service
+		uart->print((const __FlashStringHelper *)pingCommand);
+		uart->print(url);
+		uart->println(F("\""));
+
+		readFlash(pingOk, responseBuffer);
+
+		// If ping is successful
+		if (uart->find(responseBuffer))
+		{
+			// Initialize string of response time array
+			responseTimeStrPtr = responseTimeStr;
+				
+			do
+			{
+				while (!uart->available());
+				rxByte = uart->read();
+				*responseTimeStrPtr++ = rxByte;
+			}	while (rxByte != '\r');
+					
+			// Terminate the string
+			*responseTimeStrPtr = '\0';
+				
+			readFlash(lineFeed, responseBuffer);	
+	
+			if (uart->find(responseBuffer))
+			{
+				// Convert port number into string
+				sscanf(responseTimeStr, "%u", &responseTime);
+			}
+		}
+	}
+	
+	return(responseTime);
+}
+
+/*******************************************************************************
+* Name: startPing
+* Description: Start a series of pings to a server without waiting for the 
+*							 replies. Replies are processed through poll and summarized by 
+*							 getPingStats. Avoid other commands until the series completes 
+*							 as they might consume the replies.
+*
+* Argument  			Description
+* =========  			===========
+* 1. url     			URL of the server to ping.
+*									Example: www.google.com, 200.200.200.200
+*
+*	2. count				Number of pings in the series (1-255).
+*
+*	3. size					Size of each ping data in bytes.
+*
+*	4. interval			Interval between pings in ms.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the series is started or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::startPing(const char *url, unsigned char count, 
+													unsigned int size, unsigned int interval)
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// Needs GPRS connection to execute ping
+	if ((status == GPRS_ON) && (count > 0))
+	{
+		// Execute the PING service: host, repeat, interval, timeout, TTL, size
+		uart->print((const __FlashStringHelper *)pingCommand);
+		uart->print(url);
+		uart->print(F("\","));
+		uart->print(count);
+		uart->print(',');
+		uart->print(interval);
+		uart->print(',');
+		uart->print(PING_TIMEOUT);
+		uart->print(F(",,"));
+		uart->println(size);
+		
+		// Expecting an "OK" response
+		readFlash(ok, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			// Start a new series
+			memset(&pingStats, 0, sizeof(pingStats));
+			pingStats.sent = count;
+			pingSum = 0;
+			pingJitterSum = 0;
+			success = true;
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: getPingStats
+* Description: Retrieve the statistics of the ping series started with 
+*							 startPing.
+*
+* Argument  			Description
+* =========  			===========
+* 1. stats				Location to store the statistics. Round trip times (minimum, 
+*									average, maximum) are in ms. Jitter is the average difference
+*									in ms between round trip times of consecutive replies.
+*	
+* Return					Description
+* =========				===========
+* 1. complete			Returns true if all pings of the series are either replied or 
+*									lost or false if the series is still in progress.
+*
+*******************************************************************************/
+bool	WISMO228::getPingStats(pingStats_t *stats)
+{
+	*stats = pingStats;
+	
+	return ((pingStats.received + pingStats.lost) >= pingStats.sent);
+}
+#endif
+
+#if WISMO228_HTTP
+/*******************************************************************************
+* Name: getHttp
+* Description: Perform HTTP method GET to retrieve or send data to a server.
+*							 Fails right away while openSocket holds the TCP client socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. url     			URL of the server.
+*									Example: www.google.com, 200.200.200.200
+*
+* 2. path					The path or directory to access in the server. 
+*									Examples: 
+*									"/" - No directory is required.
+*									"/directory/subdirectory" - Directory is required.
+*									"/script.php?data=value" - For sending data to server.
+*
+*	3. port					Server TCP port number from 0-65535.
+*
+*	4. *message			Location to store the data retrieved from the server.
+*
+*	5. limit				The maximum length of data to received from the server. 
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the procedure is successful and false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::getHttp(const char *server, const char *path, const char	*port, 
+												char *message, unsigned int limit)
+{
+	unsigned long timeout;
+	unsigned int	count;
+	LengthCounter	counter;
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		if (openPort(SOCKET_INDEX, server, port))
+		{			
+			if (dataMode == DATA_BLOCK)
+			{
+				// Send the whole request as a single block
+				if (beginBlock(WIP_TCP_CLIENT, SOCKET_INDEX, 
+											 getRequest(&counter, server, path)))
+				{
+					getRequest(uart, server, path);
+					
+					if (endBlock())
+					{
+						timeout = millis() + 3000;
+						
+						while ((limit > 0) && (millis() < timeout))
+						{
+							count = readBlock(WIP_TCP_CLIENT, SOCKET_INDEX, message, limit);
+							message += count;
+							limit -= count;
+						}
+						
+						success = true;
+					}
+				}
+				
+				// Close the TCP socket with server
+				if (!closePort(WIP_TCP_CLIENT, SOCKET_INDEX))
+				{
+					success = false;
+				}
+			}
+			else if (exchangeData(SOCKET_INDEX))
+			{
+				getRequest(uart, server, path);
+				
+				timeout = millis() + 3000;
+				
+				while ((limit > 0) && (millis() < timeout))
+				{
+					if (uart->available())
+					{
+						*message++ = uart->read();
+						limit--;
+					}
+				}
+
+				delay(3000);
+				
+				// Revert back to AT command mode
+				uart->print((const __FlashStringHelper *)escapeSequence);
+				
+				// Expecting an "OK" response
+				readFlash(ok, responseBuffer);
+				
+				if (uart->find(responseBuffer))
+				{								
+					// Close the TCP socket with server
+					if (closePort(WIP_TCP_CLIENT, SOCKET_INDEX))
+					{
+						success = true;
+					}
+				}
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: putHttp
+* Description: Perform HTTP method PUT to send data to a server. Fails right 
+*							 away while openSocket holds the TCP client socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. server     	URL of the server.
+*									Example: www.google.com, 200.200.200.200
+*
+* 2. path					The path or directory to access in the server. 
+*									Examples: 
+*									"/" - No directory is required.
+*									"/directory/subdirectory" - Directory is required.
+*									"/script.php?data=value" - For sending data to server.
+*
+*	3. port					Server TCP port number from 0-65535.
+*
+*	4. host					Host of the residing end application. Typically same as the 
+*									server.
+*
+*	5. data				  Data in the following format:
+*									dataName1,value\r\ndataName2,value\r\n
+*									Each line consist of a data name separated by a comma and it's
+*									corresponding value. The new line feed is required for each
+*									data entry.
+*	6. controlKey		Control key name and it's value which is specified by the 
+*									server hosting the application in the following format:
+*									ControlKeyName: Value					 
+*
+* 7. contentType	Type of content which is being sent over.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the procedure is successful and false if 
+*									otherwise.	
+*
+*******************************************************************************/
+bool	WISMO228::putHttp(const char *server, const char *path, const char *port, 
+              const char *host, const char *data, const char *controlKey, 
+							const char *contentType)
+{
+	bool	success = false;
+	char	reply[RESPONSE_LENGTH_MAX];
+	LengthCounter	counter;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		// Open a port with remote server	
+		if (openPort(SOCKET_INDEX, server, port))
+		{		
+			if (dataMode == DATA_BLOCK)
+			{
+				// Send the whole request as a single block
+				if (beginBlock(WIP_TCP_CLIENT, SOCKET_INDEX, 
+											 putRequest(&counter, path, host, data, controlKey, 
+																	contentType)))
+				{
+					putRequest(uart, path, host, data, controlKey, contentType);
+					
+					if (endBlock())
+					{
+						// Status line of the server reply is sufficient
+						if (waitForBlock(WIP_TCP_CLIENT, SOCKET_INDEX, reply, 
+														 RESPONSE_LENGTH_MAX - 1, MED_TIMEOUT))
+						{
+							// Expecting an OK from remote server
+							readFlash(ok, responseBuffer);
+							
+							// If HTTP PUT request successful
+							if (strstr(reply, responseBuffer) != NULL)
+							{
+								// PUT request completed
+								success = true;
+							}
+						}
+					}
+				}
+				
+				// Port properly closed
+				closePort(WIP_TCP_CLIENT, SOCKET_INDEX);
+			}
+			// Enter transparent data mode
+			else if (exchangeData(SOCKET_INDEX))
+			{
+				putRequest(uart, path, host, data, controlKey, contentType);
+				
+				// If you need to retrieve the whole response from the remote server,
+				// retrieve the response starting from here
+				
+				// It takes more time for server to response to a PUT request	
+				uart->setTimeout(MED_TIMEOUT);
+				// Expecting an OK from remote server
+				readFlash(ok, responseBuffer);
+				
+				// If HTTP PUT request successful
+				if (uart->find(responseBuffer))
+				{
+					// Expecting a SHUTDOWN signal from remote server
+					readFlash(shutdownLink, responseBuffer);
+					
+					if (uart->find(responseBuffer))
+					{
+						// PUT request completed
+						success = true;
+					}
+				}
+				// Revert back to normal reply timeout
+				uart->setTimeout(MIN_TIMEOUT);
+						
+				// Revert back to AT command mode
+				uart->print((const __FlashStringHelper *)escapeSequence);
+				
+				// Expecting an OK from remote server
+				readFlash(ok, responseBuffer);
+						
+				if (uart->find(responseBuffer))
+				{
+					// Port properly closed
+					closePort(WIP_TCP_CLIENT, SOCKET_INDEX);
+				}
+			}
+			else
+			{
+				// Port properly closed
+				closePort(WIP_TCP_CLIENT, SOCKET_INDEX);
+			}	
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: postHttp
+* Description: Perform HTTP method POST with the body streamed from a user data 
+*							 source, so that the body does not need to reside in RAM. 
+*							 Fails right away while openSocket holds the TCP client socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. - 4.					Refer to putHttp.
+*
+*	5. controlKey		Refer to putHttp. NULL if not required by the server.
+*
+*	6. contentType	Type of content which is being sent over.
+*
+*	7. length				Length of the body in bytes or HTTP_LENGTH_UNKNOWN to send it
+*									with chunked transfer encoding.
+*
+*	8. source				Function filling the data buffer with up to size bytes of the 
+*									body and returning the number of bytes filled. 0 indicates the 
+*									end of the body.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the server replies with a 2xx status and 
+*									false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::postHttp(const char *server, const char *path, const char *port, 
+												 const char *host, const char *controlKey, 
+												 const char *contentType, unsigned long length, 
+												 unsigned int (*source)(char *data, unsigned int size))
+{
+	return (streamHttp(true, server, path, port, host, controlKey, contentType, 
+										 length, source));
+}
+
+/*******************************************************************************
+* Name: putHttp
+* Description: Perform HTTP method PUT with the body streamed from a user data 
+*							 source, so that the body does not need to reside in RAM. 
+*							 Fails right away while openSocket holds the TCP client socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. - 8.					Refer to postHttp.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the server replies with a 2xx status and 
+*									false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::putHttp(const char *server, const char *path, const char *port, 
+												const char *host, const char *controlKey, 
+												const char *contentType, unsigned long length, 
+												unsigned int (*source)(char *data, unsigned int size))
+{
+	return (streamHttp(false, server, path, port, host, controlKey, contentType, 
+										 length, source));
+}
+
+#endif
+
+#if WISMO228_MQTT
+/*******************************************************************************
+* Name: mqttHeader
+* Description: Write a MQTT fixed header at the start of the packet buffer.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Packet type & flags.
+*
+*	2. length				Remaining length of the packet.
+*
+* Return					Description
+* =========				===========
+* 1. offset				Position in packet buffer after the fixed header.
+*
+*******************************************************************************/
+unsigned int	WISMO228::mqttHeader(unsigned char type, unsigned int length)
+{
+	unsigned int	offset = 0;
+	unsigned char	encoded;
+	
+	mqttBuffer[offset++] = type;
+	
+	// Remaining length uses 7 bits per byte, MSB indicates more bytes follow
+	do
+	{
+		encoded = length & 0x7F;
+		length >>= 7;
+		
+		if (length > 0)
+		{
+			encoded |= 0x80;
+		}
+		
+		mqttBuffer[offset++] = encoded;
+	} while (length > 0);
+	
+	return (offset);
+}
+
+/*******************************************************************************
+* Name: mqttString
+* Description: Write a length prefixed MQTT string into the packet buffer.
+*
+* Argument  			Description
+* =========  			===========
+* 1. offset				Position in packet buffer.
+*
+*	2. string				String to be written.
+*
+* Return					Description
+* =========				===========
+* 1. offset				Position in packet buffer after the string.
+*
+*******************************************************************************/
+unsigned int	WISMO228::mqttString(unsigned int offset, const char *string)
+{
+	unsigned int	length;
+	
+	length = strlen(string);
+	
+	mqttBuffer[offset++] = length >> 8;
+	mqttBuffer[offset++] = length & 0xFF;
+	memcpy(&mqttBuffer[offset], string, length);
+	
+	return (offset + length);
+}
+
+/*******************************************************************************
+* Name: mqttSend
+* Description: Send the packet buffer to the broker as a single block.
+*
+* Argument  			Description
+* =========  			===========
+* 1. length				Number of bytes in the packet buffer.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the packet is sent or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttSend(unsigned int length)
+{
+	bool	success = false;
+	
+	if (beginBlock(WIP_TCP_CLIENT, MQTT_SOCKET_INDEX, length))
+	{
+		uart->write((const uint8_t *)mqttBuffer, length);
+		
+		if (endBlock())
+		{
+			mqttLastSent = millis();
+			success = true;
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttRead
+* Description: Retrieve an exact number of bytes from the broker.
+*
+* Argument  			Description
+* =========  			===========
+* 1. data					Location to store the data or NULL to discard it.
+*
+*	2. count				Number of bytes to retrieve.
+*
+*	3. period				Time frame to wait for the data in ms.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if all bytes are retrieved or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttRead(char *data, unsigned int count, long period)
+{
+	unsigned long	timeout;
+	unsigned int	received;
+	char	discard[RESPONSE_LENGTH_MAX];
+	
+	timeout = millis() + period;
+	
+	while (count > 0)
+	{
+		if (data != NULL)
+		{
+			received = readBlock(WIP_TCP_CLIENT, MQTT_SOCKET_INDEX, data, count);
+			data += received;
+		}
+		else
+		{
+			received = readBlock(WIP_TCP_CLIENT, MQTT_SOCKET_INDEX, discard, 
+													 min(count, sizeof(discard)));
+		}
+		
+		count -= received;
+		
+		if ((received == 0) && (timeout <= millis()))
+		{
+			break;
+		}
+	}
+	
+	return (count == 0);
+}
+
+/*******************************************************************************
+* Name: mqttReadPacket
+* Description: Retrieve a complete packet from the broker into the packet buffer 
+*							 (without the fixed header). Bytes exceeding the packet buffer 
+*							 are discarded. Every packet is at least 2 bytes long, so the 
+*							 packet type & the first length byte are retrieved together 
+*							 without consuming the next packet.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Received packet type & flags.
+*
+*	2. length				Remaining length of the packet. Only the first 
+*									MQTT_PACKET_MAX bytes are stored in the packet buffer.
+*
+*	3. period				Time frame to wait for the start of a packet in ms.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if a packet is retrieved or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttReadPacket(unsigned char *type, unsigned int *length, 
+															 long period)
+{
+	bool	success = false;
+	char	header[MQTT_HEADER_MAX];
+	unsigned int	received;
+	unsigned int	remaining = 0;
+	unsigned char	index = 1;
+	unsigned char	shift = 0;
+	unsigned long	timeout;
+	
+	timeout = millis() + period;
+	
+	do
+	{
+		received = readBlock(WIP_TCP_CLIENT, MQTT_SOCKET_INDEX, header, 2);
+	} while ((received == 0) && (timeout > millis()));
+	
+	if (received > 0)
+	{
+		// Remainder of the packet follows closely
+		success = (received == 2) || mqttRead(&header[1], 1, MIN_TIMEOUT);
+		
+		// Remaining length above 127 is followed by at least 128 bytes, the rest 
+		// of the header can be retrieved at once
+		if (success && (header[1] & 0x80))
+		{
+			success = mqttRead(&header[2], MQTT_HEADER_MAX - 2, MIN_TIMEOUT);
+			received = MQTT_HEADER_MAX;
+		}
+		else
+		{
+			received = 2;
+		}
+		
+		// Decode remaining length
+		while (success)
+		{
+			remaining |= (unsigned int)(header[index] & 0x7F) << shift;
+			shift += 7;
+			
+			if (!(header[index++] & 0x80))
+			{
+				break;
+			}
+			
+			// Remaining length is limited to 4 bytes
+			if (index == MQTT_HEADER_MAX)
+			{
+				success = false;
+			}
+		}
+		
+		if (success)
+		{
+			*type = header[0];
+			*length = remaining;
+			
+			// Header bytes beyond the remaining length belong to the packet
+			received -= index;
+			memcpy(mqttBuffer, &header[index], received);
+			remaining = min(remaining, MQTT_PACKET_MAX);
+			
+			success = mqttRead(&mqttBuffer[received], remaining - received, 
+												 MIN_TIMEOUT) &&
+								mqttRead(NULL, *length - remaining, MIN_TIMEOUT);
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttWaitFor
+* Description: Wait for an acknowledgement packet from the broker. Messages 
+*							 published by the broker in the meantime are processed.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Expected packet type.
+*
+*	2. packetId			Expected packet identifier or 0 if not applicable.
+*
+*	3. minimum			Minimum remaining length of the expected packet.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the expected packet is received or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttWaitFor(unsigned char type, unsigned int packetId, 
+														unsigned int minimum)
+{
+	bool	success = false;
+	unsigned char	receivedType;
+	unsigned int	length;
+	unsigned long	timeout;
+	
+	timeout = millis() + MED_TIMEOUT;
+	
+	while (timeout > millis())
+	{
+		if (mqttReadPacket(&receivedType, &length, timeout - millis()))
+		{
+			if (receivedType == type)
+			{
+				if ((length >= minimum) && (length <= MQTT_PACKET_MAX) && 
+						((packetId == 0) || 
+						 ((length >= 2) && 
+						  ((unsigned int)(((unsigned char)mqttBuffer[0] << 8) | 
+														  (unsigned char)mqttBuffer[1]) == packetId))))
+				{
+					success = true;
+					break;
+				}
+			}
+			else
+			{
+				mqttReceived(receivedType, length);
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttReceived
+* Description: Process a packet pushed by the broker. Published messages are 
+*							 acknowledged when required and passed to the message handler.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Packet type & flags.
+*
+*	2. length				Number of bytes in the packet buffer.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::mqttReceived(unsigned char type, unsigned int length)
+{
+	unsigned int	topicLength;
+	unsigned int	payload;
+	unsigned int	packetId = 0;
+	
+	if ((type & 0xF0) == MQTT_PUBLISH)
+	{
+		// Truncated packets are dropped
+		if ((length >= 2) && (length <= MQTT_PACKET_MAX))
+		{
+			topicLength = ((unsigned char)mqttBuffer[0] << 8) | 
+										(unsigned char)mqttBuffer[1];
+			
+			// Topic must lie within the packet
+			if (topicLength <= (length - 2))
+			{
+				payload = 2 + topicLength;
+				
+				// QoS 1 & 2 carry a packet identifier
+				if (type & 0x06)
+				{
+					payload += 2;
+				}
+				
+				if (payload <= length)
+				{
+					if (type & 0x06)
+					{
+						packetId = ((unsigned char)mqttBuffer[payload - 2] << 8) | 
+											 (unsigned char)mqttBuffer[payload - 1];
+					}
+					
+					// Terminate the payload and move the topic in front of it's length 
+					// to terminate the topic
+					mqttBuffer[length] = '\0';
+					memmove(mqttBuffer, &mqttBuffer[2], topicLength);
+					mqttBuffer[topicLength] = '\0';
+					
+					if (mqttFunctionPtr != NULL)
+					{
+						mqttFunctionPtr(mqttBuffer, &mqttBuffer[payload]);
+					}
+				}
+			}
+		}
+		
+		// Only delivered messages are acknowledged, MQTT 3.1.1 has no negative 
+		// acknowledgement so the broker keeps a dropped message as unacknowledged
+		if (packetId != 0)
+		{
+			mqttBuffer[2] = packetId >> 8;
+			mqttBuffer[3] = packetId & 0xFF;
+			mqttHeader(MQTT_PUBACK, 2);
+			mqttSend(4);
+		}
+	}
+}
+#endif
+
+#if WISMO228_HTTP
+/*******************************************************************************
+* Name: getRequest
+* Description: Print a HTTP GET request.
+*
+* Argument  			Description
+* =========  			===========
+* 1. out					Destination of the request (TX buffer or length counter).
+*
+* 2. server				Server name which is also used as the host.
+*
+*	3. path					The path or directory to access in the server.
+*
+* Return					Description
+* =========				===========
+* 1. length				Number of characters in the request.
+*
+*******************************************************************************/
+size_t	WISMO228::getRequest(Print *out, const char *server, const char *path)
+{
+	const char	*fields[2];
+	
+	fields[0] = path;
+	fields[1] = server;
+	
+	return (printTemplate(out, httpGetTemplate, fields));
+}
+
+/*******************************************************************************
+* Name: putRequest
+* Description: Print a HTTP PUT request including the data.
+*
+* Argument  			Description
+* =========  			===========
+* 1. out					Destination of the request (TX buffer or length counter).
+*
+* 2. - 6.					Refer to putHttp.
+*
+* Return					Description
+* =========				===========
+* 1. length				Number of characters in the request.
+*
+*******************************************************************************/
+size_t	WISMO228::putRequest(Print *out, const char *path, const char *host, 
+														 const char *data, const char *controlKey, 
+														 const char *contentType)
+{
+	const char	*fields[6];
+	char	contentLength[11];
+	
+	ultoa(strlen(data), contentLength, 10);
+	
+	fields[0] = path;
+	fields[1] = host;
+	fields[2] = controlKey;
+	fields[3] = contentLength;
+	fields[4] = contentType;
+	fields[5] = data;
+	
+	return (printTemplate(out, httpPutTemplate, fields));
+}
+
+/*******************************************************************************
+* Name: printTemplate
+* Description: Print a request template stored in flash memory, replacing each 
+*							 placeholder (%0 - %9) by the corresponding field. A NULL 
+*							 field leaves out the rest of its line.
+*
+* Argument  			Description
+* =========  			===========
+* 1. out					Destination of the request (TX buffer or length counter).
+*
+* 2. format				Template in flash memory.
+*
+*	3. fields				Strings replacing the placeholders, indexed by placeholder 
+*									number.
+*
+* Return					Description
+* =========				===========
+* 1. length				Number of characters printed.
+*
+*******************************************************************************/
+size_t	WISMO228::printTemplate(Print *out, const char *format, 
+																const char * const *fields)
+{
+	size_t	length = 0;
+	char	character;
+	
+	character = pgm_read_byte(format++);
+	
+	while (character != '\0')
+	{
+		if (character == '%')
+		{
+			character = pgm_read_byte(format++);
+			
+			if (fields[character - '0'] != NULL)
+			{
+				length += out->print(fields[character - '0']);
+			}
+			else
+			{
+				// Field is optional, leave out the rest of its line
+				do
+				{
+					character = pgm_read_byte(format++);
+				} while ((character != '\n') && (character != '\0'));
+				
+				// Template ends with an optional field
+				if (character == '\0')
+				{
+					format--;
+				}
+			}
+		}
+		else
+		{
+			length += out->write(character);
+		}
+		
+		character = pgm_read_byte(format++);
+	}
+	
+	return (length);
+}
+
+/*******************************************************************************
+* Name: streamHttp
+* Description: Send a HTTP request with the body streamed from a user data 
+*							 source. In block mode the header & each chunk of the body is 
+*							 sent as a block, in transparent mode they are written straight 
+*							 into the connection.
+*
+* Argument  			Description
+* =========  			===========
+* 1. post					True for method POST or false for method PUT.
+*
+* 2. - 9.					Refer to postHttp.
+*
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the server replies with a 2xx status and 
+*									false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::streamHttp(bool post, const char *server, const char *path, 
+													 const char *port, const char *host, 
+													 const char *controlKey, const char *contentType, 
+													 unsigned long length, 
+													 unsigned int (*source)(char *data, unsigned int size))
+{
+	bool	success = false;
+	bool	chunked;
+	char	data[HTTP_CHUNK_MAX];
+	char	chunkSize[5];
+	char	reply[RESPONSE_LENGTH_MAX];
+	char	*replyPtr;
+	unsigned int	count;
+	unsigned int	limit;
+	unsigned int	framing = 0;
+	unsigned long	remaining;
+	int	code = 0;
+	LengthCounter	counter;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	chunked = (length == HTTP_LENGTH_UNKNOWN);
+	remaining = length;
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		// Open a port with remote server	
+		if (openPort(SOCKET_INDEX, server, port))
+		{
+			if ((dataMode == DATA_BLOCK) || exchangeData(SOCKET_INDEX))
+			{
+				if (beginSegment(SOCKET_INDEX, 
+												 streamRequest(&counter, post, path, host, controlKey, 
+																			 contentType, length)))
+				{
+					streamRequest(uart, post, path, host, controlKey, contentType, length);
+					success = endSegment();
+				}
+				
+				while (success)
+				{
+					// A known length is never exceeded
+					limit = HTTP_CHUNK_MAX;
+					
+					if ((!chunked) && (remaining < limit))
+					{
+						limit = remaining;
+					}
+					
+					count = 0;
+					
+					if (limit > 0)
+					{
+						count = source(data, limit);
+						
+						if (count > limit)
+						{
+							count = limit;
+						}
+					}
+					
+					if (chunked)
+					{
+						// Chunk is framed as <size in hex>\r\n<data>\r\n, an empty chunk 
+						// ends the body
+						itoa(count, chunkSize, 16);
+						framing = strlen(chunkSize) + 4;
+					}
+					else
+					{
+						remaining -= count;
+					}
+					
+					if ((count > 0) || chunked)
+					{
+						if (beginSegment(SOCKET_INDEX, count + framing))
+						{
+							if (chunked)
+							{
+								uart->print(chunkSize);
+								uart->print(F("\r\n"));
+							}
+							uart->write((const uint8_t *)data, count);
+							if (chunked)
+							{
+								uart->print(F("\r\n"));
+							}
+							
+							success = endSegment();
+						}
+						else
+						{
+							success = false;
+						}
+					}
+					
+					// End of the body
+					if (count == 0)
+					{
+						break;
+					}
+				}
+				
+				// Body ended before the announced length
+				if (remaining > 0)
+				{
+					success = false;
+				}
+				
+				if (success)
+				{
+					success = false;
+					
+					if (dataMode == DATA_BLOCK)
+					{
+						if (waitForBlock(WIP_TCP_CLIENT, SOCKET_INDEX, reply, 
+														 RESPONSE_LENGTH_MAX - 1, MED_TIMEOUT))
+						{
+							// Expecting the status line of the server reply
+							readFlash(httpStatus, responseBuffer);
+							replyPtr = strstr(reply, responseBuffer);
+							
+							if (replyPtr != NULL)
+							{
+								replyPtr = strchr(replyPtr, ' ');
+							}
+							
+							if (replyPtr != NULL)
+							{
+								code = atoi(replyPtr + 1);
+							}
+						}
+					}
+					else
+					{
+						// It takes more time for server to process the body
+						uart->setTimeout(MED_TIMEOUT);
+						// Expecting the status line of the server reply
+						readFlash(httpStatus, responseBuffer);
+						
+						if (uart->find(responseBuffer))
+						{
+							// Skip the minor version
+							uart->parseInt();
+							code = uart->parseInt();
+							
+							// Expecting a SHUTDOWN signal from remote server
+							readFlash(shutdownLink, responseBuffer);
+							uart->find(responseBuffer);
+						}
+						
+						// Revert back to normal reply timeout
+						uart->setTimeout(MIN_TIMEOUT);
+					}
+					
+					if ((code >= 200) && (code < 300))
+					{
+						success = true;
+					}
+				}
+				
+				if (dataMode == DATA_BLOCK)
+				{
+					// Port properly closed
+					closePort(WIP_TCP_CLIENT, SOCKET_INDEX);
+				}
+				else
+				{
+					// Revert back to AT command mode
+					uart->print((const __FlashStringHelper *)escapeSequence);
+					
+					// Expecting an OK from remote server
+					readFlash(ok, responseBuffer);
+					
+					if (uart->find(responseBuffer))
+					{
+						// Port properly closed
+						closePort(WIP_TCP_CLIENT, SOCKET_INDEX);
+					}
+				}
+			}
+			else
+			{
+				// Port properly closed
+				closePort(WIP_TCP_CLIENT, SOCKET_INDEX);
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: streamRequest
+* Description: Print the header of a HTTP request which body is streamed.
+*
+* Argument  			Description
+* =========  			===========
+* 1. out					Destination of the header (TX buffer or length counter).
+*
+* 2. post					True for method POST or false for method PUT.
+*
+* 3. - 7.					Refer to postHttp.
+*
+* Return					Description
+* =========				===========
+* 1. length				Number of characters in the header.
+*
+*******************************************************************************/
+size_t	WISMO228::streamRequest(Print *out, bool post, const char *path, 
+																const char *host, const char *controlKey, 
+																const char *contentType, unsigned long length)
+{
+	const char	*fields[4];
+	size_t	size = 0;
+	
+	fields[0] = path;
+	fields[1] = host;
+	fields[2] = controlKey;
+	fields[3] = contentType;
+	
+	if (post)
+	{
+		size += out->print(F("POST"));
+	}
+	else
+	{
+		size += out->print(F("PUT"));
+	}
+	
+	size += printTemplate(out, httpStreamTemplate, fields);
+	
+	if (length == HTTP_LENGTH_UNKNOWN)
+	{
+		size += out->println(F("Transfer-Encoding: chunked"));
+	}
+	else
+	{
+		size += out->print(F("Content-Length: "));
+		size += out->println(length);
+	}
+	
+	size += out->println();
+	
+	return (size);
+}
+#endif
+
+#if WISMO228_HTTP || WISMO228_EMAIL
+/*******************************************************************************
+* Name: beginSegment
+* Description: Start a segment of a request on a client socket. In block mode
+*							 the segment is sent as a block, in transparent mode nothing 
+*							 needs to be done.
+*
+* Argument  			Description
+* =========  			===========
+* 1. index				Socket index.
+*
+*	2. length				Number of bytes in the segment.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the segment can be written or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::beginSegment(unsigned char index, unsigned int length)
+{
+	bool	success = true;
+	
+	if (dataMode == DATA_BLOCK)
+	{
+		success = beginBlock(WIP_TCP_CLIENT, index, length);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: endSegment
+* Description: Complete a segment of a request on the client socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the segment is accepted or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::endSegment()
+{
+	bool	success = true;
+	
+	if (dataMode == DATA_BLOCK)
+	{
+		success = endBlock();
+	}
+	
+	return (success);
+}
+#endif
+
+#if WISMO228_EMAIL
+/*******************************************************************************
+* Name: sendEmail
+* Description: Send an email through SMTP server.
+*
+* Argument  			Description
+* =========  			===========
+* 1. smtpServer   SMTP server name.
+*									Example: mail.yourdomain.com
+*
+* 2. port					SMTP port number. Usually is 25.
+*
+*	3. username			Complete username (email address).
+*									Example: user@yourdomain.com
+*
+*	4. password			Corresponding password for the username.
+*
+*	5. recipient		Recipient email address.
+*									Example: recipient@somedomain.com
+*
+*	6. title				Title or subject of the email.
+*									Example: Hello World!
+*
+*	7. message			Content of the email.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the procedure is successful and false if 
+*									otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::sendEmail(const char *smtpServer, const char *port, 
+												 const char *username, const char *password, 
+												 const char *recipient, const char *title, 
+												 const char *content)
+{
+	bool	success = false;
+	
+	if (openEmail(smtpServer, port, username, password))
+	{
+		success = sendEmail(recipient, title, content);
+		
+		if (!closeEmail())
+		{
+			success = false;
+		}
+	}
+	
+	return (success);	
+}
+
+/*******************************************************************************
+* Name: sendEmail
+* Description: Send an email to several recipients through SMTP server.
+*
+* Argument  			Description
+* =========  			===========
+* 1. - 4.					Refer to sendEmail for a single recipient.
+*
+*	5. recipients		List of recipient email addresses.
+*
+*	6. recipientCount	Number of recipients in the list.
+*
+*	7. title				Title or subject of the email.
+*
+*	8. content			Content of the email.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the email is accepted by the server for at 
+*									least one of the recipients or false if otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::sendEmail(const char *smtpServer, const char *port, 
+												 const char *username, const char *password, 
+												 const char * const *recipients, 
+												 unsigned char recipientCount, const char *title, 
+												 const char *content)
+{
+	bool	success = false;
+	
+	if (openEmail(smtpServer, port, username, password))
+	{
+		success = sendEmail(recipients, recipientCount, title, content);
+		
+		if (!closeEmail())
+		{
+			success = false;
+		}
+	}
+	
+	return (success);	
+}
+
+/*******************************************************************************
+* Name: openEmail
+* Description: Open a SMTP session which is authenticated once and can be used 
+*							 to send several emails through sendEmail. Email envelope 
+*							 commands are pipelined (RFC 2920) when the server supports it.
+*							 The session has a socket of its own (SMTP_SOCKET_INDEX). In 
+*							 transparent data mode it holds the UART, so no other socket 
+*							 can be opened until closeEmail.
+*
+* Argument  			Description
+* =========  			===========
+* 1. smtpServer   SMTP server name.
+*									Example: mail.yourdomain.com
+*
+* 2. port					SMTP port number. Usually is 25.
+*
+*	3. username			Complete username (email address) which is also used as the 
+*									sender of all emails in the session.
+*									Example: user@yourdomain.com
+*
+*	4. password			Corresponding password for the username.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the session is authenticated or false if 
+*									otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::openEmail(const char *smtpServer, const char *port, 
+												 const char *username, const char *password)
+{
+	bool	success = false;
+	char	base64[50];
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		if (openPort(SMTP_SOCKET_INDEX, smtpServer, port))
+		{
+			// Greeting is retrieved in data mode or through blocks
+			if ((dataMode == DATA_BLOCK) || exchangeData(SMTP_SOCKET_INDEX))
+			{
+				// Nothing retrieved from the server yet
+				smtpStart = 0;
+				smtpBuffered = 0;
+				
+				// Retrieving data from web takes longer time
+				uart->setTimeout(MAX_TIMEOUT);
+				
+				if (smtpReply(smtpGreeting))
+				{
+					// Extensions are recorded from the reply
+					smtpPipelining = false;
+					
+					// Start communicating with server using extended SMTP protocol
+					if (smtpCommand(F("EHLO "), smtpServer, NULL) && smtpReply(smtpOk))
+					{
+						// Initiate account login, server prompts for the username and 
+						// password in base 64 format
+						if (smtpCommand(F("AUTH LOGIN"), NULL, NULL) && 
+								smtpReply(smtpAuthenticationPrompt))
+						{
+							// Send username in base 64 format
+							encodeBase64(username, base64);
+							
+							if (smtpCommand(NULL, base64, NULL) && 
+									smtpReply(smtpAuthenticationPrompt))
+							{
+								// Send password in base 64 format
+								encodeBase64(password, base64);
+								
+								// If receive authentication success
+								if (smtpCommand(NULL, base64, NULL) && 
+										smtpReply(smtpAuthenticationOk))
+								{
+									// Sender of all emails in this session
+									emailSender = username;
+									socketsOpen |= 1 << SMTP_SOCKET_INDEX;
+									success = true;
+								}
+							}
+						}
+					}
+				}
+				
+				if ((!success) && (dataMode != DATA_BLOCK))
+				{
+					// Revert to AT command mode
+					delay(1000);
+					uart->print((const __FlashStringHelper *)escapeSequence);
+					
+					readFlash(ok, responseBuffer);
+					uart->find(responseBuffer);
+				}
+			}
+			
+			uart->setTimeout(MIN_TIMEOUT);
+			
+			if (!success)
+			{
+				closePort(WIP_TCP_CLIENT, SMTP_SOCKET_INDEX);
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: sendEmail
+* Description: Send an email through the SMTP session opened with openEmail.
+*
+* Argument  			Description
+* =========  			===========
+* 1. recipient		Recipient email address.
+*									Example: recipient@somedomain.com
+*
+*	2. title				Title or subject of the email.
+*									Example: Hello World!
+*
+*	3. content			Content of the email.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the email is accepted by the server or false 
+*									if otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::sendEmail(const char *recipient, const char *title, 
+												 const char *content)
+{
+	return (sendEmail(&recipient, 1, title, content));
+}
+
+/*******************************************************************************
+* Name: sendEmail
+* Description: Send an email to several recipients in a single SMTP transaction
+*							 through the session opened with openEmail. The email content 
+*							 is sent once for all recipients.
+*
+* Argument  			Description
+* =========  			===========
+* 1. recipients		List of recipient email addresses.
+*
+*	2. recipientCount	Number of recipients in the list.
+*
+*	3. title				Title or subject of the email.
+*									Example: Hello World!
+*
+*	4. content			Content of the email.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the email is accepted by the server for at 
+*									least one of the recipients or false if otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::sendEmail(const char * const *recipients, 
+												 unsigned char recipientCount, const char *title, 
+												 const char *content)
+{
+	return (sendEmail(recipients, recipientCount, title, content, NULL, NULL));
+}
+
+/*******************************************************************************
+* Name: sendEmail
+* Description: Send an email with an attachment to several recipients through 
+*							 the session opened with openEmail. The attachment is read from 
+*							 a user data source and encoded into base 64 on the fly, so it 
+*							 does not need to fit in RAM. If the attachment cannot be sent 
+*							 completely, the email is not terminated & the transaction is 
+*							 reset so the server does not deliver it.
+*
+* Argument  			Description
+* =========  			===========
+* 1. - 4.					Refer to sendEmail for several recipients.
+*
+*	5. attachmentName	File name of the attachment.
+*										Example: log.csv
+*
+*	6. source				Function filling the data buffer with up to size bytes of the
+*									attachment and returning the number of bytes filled. Returns 
+*									0 when the end of the attachment is reached.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the email is accepted by the server for at 
+*									least one of the recipients or false if otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::sendEmail(const char * const *recipients, 
+												 unsigned char recipientCount, const char *title, 
+												 const char *content, const char *attachmentName, 
+												 unsigned int (*source)(char *data, unsigned int size))
+{
+	bool	success = false;
+	bool	started = false;
+	bool	terminated = false;
+	bool	senderOk;
+	unsigned char	index;
+	unsigned char	accepted = 0;
+	LengthCounter	counter;
+	
+	if ((status == GPRS_ON) && (emailSender != NULL) && (recipientCount > 0))
+	{
+		// Email replies are slow
+		uart->setTimeout(MAX_TIMEOUT);
+		
+		// Email sender, without pipelining wait for every reply before the next 
+		// command
+		senderOk = smtpCommand(F("MAIL FROM: <"), emailSender, F(">")) && 
+							 (smtpPipelining || smtpReply(smtpOk));
+		
+		if (senderOk)
+		{
+			// Email recipients
+			for (index = 0; index < recipientCount; index++)
+			{
+				if (smtpCommand(F("RCPT TO: <"), recipients[index], F(">")) && 
+						!smtpPipelining && smtpReply(smtpOk))
+				{
+					accepted++;
+				}
+			}
+			
+			if (smtpPipelining)
+			{
+				// Start of email body
+				smtpCommand(F("DATA"), NULL, NULL);
+				
+				// All replies arrive in order after DATA
+				senderOk = smtpReply(smtpOk);
+				
+				for (index = 0; index < recipientCount; index++)
+				{
+					if (smtpReply(smtpOk) && senderOk)
+					{
+						accepted++;
+					}
+				}
+				
+				// Server rejects DATA if no recipient is accepted
+				started = smtpReply(smtpInputPrompt);
+			}
+			else if (accepted > 0)
+			{
+				// Start of email body
+				started = smtpCommand(F("DATA"), NULL, NULL) && 
+									smtpReply(smtpInputPrompt);
+			}
+		}
+		
+		if (started)
+		{
+			// Email header & message
+			if (source == NULL)
+			{
+				attachmentName = NULL;
+			}
+			
+			if (beginSegment(SMTP_SOCKET_INDEX, smtpMessage(&counter, recipients, recipientCount, 
+																	 title, content, attachmentName)))
+			{
+				smtpMessage(uart, recipients, recipientCount, title, content, 
+										attachmentName);
+				
+				if (endSegment())
+				{
+					if (source != NULL)
+					{
+						// Attachment in lines of 76 characters, a partly sent attachment
+						// must not be terminated as a complete email
+						if (encodeBase64(source))
+						{
+							terminated = smtpCommand(F("--" MIME_BOUNDARY "--\r\n."), 
+																			 NULL, NULL);
+						}
+					}
+					else
+					{
+						terminated = smtpCommand(F("\r\n."), NULL, NULL);
+					}
+				}
+			}
+			
+			// Email successfully sent
+			if (terminated)
+			{
+				success = smtpReply(smtpOk);
+			}
+		}
+		
+		if (!terminated)
+		{
+			// Abort the transaction, session remains usable
+			smtpCommand(F("RSET"), NULL, NULL);
+			smtpReply(smtpOk);
+		}
+		
+		uart->setTimeout(MIN_TIMEOUT);
+	}
+	
+	return (success);	
+}
+
+/*******************************************************************************
+* Name: closeEmail
+* Description: End the SMTP session opened with openEmail.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the session is closed properly or false if 
+*									otherwise.
+*
+*******************************************************************************/	
+bool WISMO228::closeEmail()
+{
+	bool	success = false;
+	
+	if ((status == GPRS_ON) && (emailSender != NULL))
+	{
+		emailSender = NULL;
+		
+		uart->setTimeout(MAX_TIMEOUT);
+		
+		smtpCommand(F("QUIT"), NULL, NULL);
+		smtpReply(smtpClosing);
+		
+		uart->setTimeout(MIN_TIMEOUT);
+		
+		if (dataMode == DATA_BLOCK)
+		{
+			// Module remains in AT command mode
+			success = closePort(WIP_TCP_CLIENT, SMTP_SOCKET_INDEX);
+		}
+		else
+		{
+			// WISMO228 gets exhausted after sending an email
+			// Give him a short break
+			delay(1000);
+			// Revert to AT command mode
+			uart->print((const __FlashStringHelper *)escapeSequence);
+			
+			readFlash(ok, responseBuffer);
+			
+			// Data mode exited successfully
+			if (uart->find(responseBuffer))
+			{
+				// Close the TCP socket
+				if (closePort(WIP_TCP_CLIENT, SMTP_SOCKET_INDEX))
+				{
+					success = true;
+				}	
+			}
+		}
+	}
+	
+	return (success);
+}
+#endif
+
+#if WISMO228_GPRS
+/*******************************************************************************
+* Name: setDataMode
+* Description: Select how data is exchanged over a socket with a remote server.
+*
+* Argument  			Description
+* =========  			===========
+* 1. mode					DATA_TRANSPARENT - Data is exchanged in transparent mode 
+*									(AT+WIPDATA) which is exited through "+++" escape sequence.
+*									DATA_BLOCK - Data is exchanged in blocks of known length 
+*									(AT+WIPDATARW) which leaves the module in AT command mode.
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setDataMode(dataMode_t mode)
+{
+	dataMode = mode;
+}
+
+/*******************************************************************************
+* Name: openSocket
+* Description: Open a TCP socket with a server which is kept open for data 
+*							 exchange in block mode. The socket is shared with the HTTP 
+*							 requests, which fail until it is closed, and fails right away 
+*							 if already open.
+*
+* Argument  			Description
+* =========  			===========
+* 1. server				Server name or IP.
+*									Example: www.google.com, 200.200.200.200
+*
+*	2. port					Server TCP port number from 0-65535.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the socket is open or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::openSocket(const char *server, const char *port)
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		if (openPort(SOCKET_INDEX, server, port))
+		{
+			// HTTP requests share the socket, they fail until it is closed
+			socketsOpen |= 1 << SOCKET_INDEX;
+			success = true;
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: closeSocket
+* Description: Close the TCP socket opened through openSocket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the socket is closed or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::closeSocket()
+{
+	return (closeSocket(SOCKET_INDEX));
+}
+
+/*******************************************************************************
+* Name: writeSocket
+* Description: Send a block of data through the socket opened with openSocket. 
+*							 Module remains in AT command mode.
+*
+* Argument  			Description
+* =========  			===========
+* 1. data					Data to be sent (may contain any byte value).
+*
+*	2. length				Number of bytes to be sent.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the data is accepted by the module or false 
+*									if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::writeSocket(const char *data, unsigned int length)
+{
+	return (writeSocket(SOCKET_INDEX, data, length));
+}
+
+/*******************************************************************************
+* Name: readSocket
+* Description: Retrieve data received on the socket opened with openSocket 
+*							 without waiting for more to arrive.
+*
+* Argument  			Description
+* =========  			===========
+* 1. data					Location to store the received data.
+*
+*	2. limit				The maximum number of bytes to retrieve.
+*	
+* Return					Description
+* =========				===========
+* 1. count	 			Number of bytes retrieved. 0 if no data is pending.
+*
+*******************************************************************************/
+unsigned int	WISMO228::readSocket(char *data, unsigned int limit)
+{
+	return (readSocket(SOCKET_INDEX, data, limit));
+}
+#endif
+
+#if WISMO228_SERVER
+/*******************************************************************************
+* Name: openServer
+* Description: Create a TCP server socket listening for incoming connections. 
+*							 Accepted connections are reported through poll to the accept 
+*							 handler and are exchanged in block mode using the socket 
+*							 number passed to the handler.
+*
+* Argument  			Description
+* =========  			===========
+* 1. port					Local TCP port number from 1-65535.
+*
+*	2. acceptFunction	Handler receiving the socket number (SERVER_SOCKET_FIRST to 
+*										SERVER_SOCKET_LAST) of an accepted connection.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the server socket is created or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::openServer(const char *port, 
+													 void (*acceptFunction)(unsigned char socket))
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		acceptFunctionPtr = acceptFunction;
+		
+		// Accepted connections are spawned on a range of TCP client sockets
+		uart->print(F("AT+WIPCREATE=3,"));
+		uart->print(SERVER_INDEX);
+		uart->print(',');
+		uart->print(port);
+		uart->print(',');
+		uart->print(SERVER_SOCKET_FIRST);
+		uart->print(',');
+		uart->println(SERVER_SOCKET_LAST);
+		
+		// Expecting an "OK" response
+		readFlash(ok, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			success = true;
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: closeServer
+* Description: Stop listening for incoming connections. Accepted connections are
+*							 not affected.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the server socket is closed or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::closeServer()
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		success = closePort(WIP_TCP_SERVER, SERVER_INDEX);
+	}
+	
+	return (success);
+}
+#endif
+
+#if WISMO228_GPRS
+/*******************************************************************************
+* Name: closeSocket
+* Description: Close a TCP socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. socket				Socket number passed to the accept handler.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the socket is closed or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::closeSocket(unsigned char socket)
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		success = closePort(WIP_TCP_CLIENT, socket);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: writeSocket
+* Description: Send a block of data through a TCP socket. Module remains in AT 
+*							 command mode.
+*
+* Argument  			Description
+* =========  			===========
+* 1. socket				Socket number passed to the accept handler.
+*
+* 2. data					Data to be sent (may contain any byte value).
+*
+*	3. length				Number of bytes to be sent.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the data is accepted by the module or false 
+*									if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::writeSocket(unsigned char socket, const char *data, 
+														unsigned int length)
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		if (beginBlock(WIP_TCP_CLIENT, socket, length))
+		{
+			uart->write((const uint8_t *)data, length);
+			success = endBlock();
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: readSocket
+* Description: Retrieve data received on a TCP socket without waiting for more 
+*							 to arrive.
+*
+* Argument  			Description
+* =========  			===========
+* 1. socket				Socket number passed to the accept handler.
+*
+* 2. data					Location to store the received data.
+*
+*	3. limit				The maximum number of bytes to retrieve.
+*	
+* Return					Description
+* =========				===========
+* 1. count	 			Number of bytes retrieved. 0 if no data is pending.
+*
+*******************************************************************************/
+unsigned int	WISMO228::readSocket(unsigned char socket, char *data, 
+																	 unsigned int limit)
+{
+	unsigned int	count = 0;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		count = readBlock(WIP_TCP_CLIENT, socket, data, limit);
+	}
+	
+	return (count);
+}
+#endif
+
+/*******************************************************************************
+* Name: poll
+* Description: Process unsolicited result codes pending from the WISMO228 
+*							 module. Call this frequently from the sketch loop.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::poll()
+{
+	char	line[LINE_LENGTH_MAX];
+#if WISMO228_SERVER
+	char	*linePtr;
+#endif
+#if WISMO228_GPRS
+	int	registration;
+#endif
+	bool	idle = true;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+#if WISMO228_EMAIL
+	// SMTP session keeps transparent data mode open
+	if ((emailSender != NULL) && (dataMode != DATA_BLOCK))
+	{
+		idle = false;
+	}
+#endif
+#if WISMO228_PING
+	// Replies of a running ping series would be consumed by other commands
+	if ((pingStats.received + pingStats.lost) < pingStats.sent)
+	{
+		idle = false;
+	}
+#endif
+	
+	// Signal quality monitor
+	if (idle && (signalInterval > 0) && (status != OFF) && 
+			((millis() - signalSampled) >= signalInterval))
+	{
+		signalSampled = millis();
+		sampleSignal();
+	}
+	
+#if WISMO228_GPRS
+	// GPRS link supervisor
+	if (idle && (linkInterval > 0) && (linkApn != NULL) && (status != OFF) && 
+			((millis() - linkChecked) >= linkPeriod))
+	{
+		linkChecked = millis();
+		superviseLink();
+	}
+#endif
+	
+#if WISMO228_CLOCK
+	// Periodic resync of the local timebase
+	if (idle && timeSynced && (timeInterval > 0) && (status == ON) && 
+			((millis() - timeChecked) >= timeInterval))
+	{
+		// Try again on the next interval if the module is busy
+		timeChecked = millis();
+		updateTime();
+	}
+#endif
+	
+	while (uart->available())
+	{
+		if (readLine(line, LINE_LENGTH_MAX))
+		{
+#if WISMO228_SERVER
+			// Incoming connection: +WIPACCEPT: <server index>,<socket index>
+			if (lineStartsWith(line, serverAccept))
+			{
+				linePtr = strchr(line, ',');
+				
+				if ((linePtr != NULL) && (acceptFunctionPtr != NULL))
+				{
+					acceptFunctionPtr(atoi(linePtr + 1));
+				}
+			}
+#endif
+#if WISMO228_GPRS
+			// Registration change: +CREG: <stat>
+			if (lineStartsWith(line, networkStatus) && (linkInterval > 0) && 
+					(linkApn != NULL))
+			{
+				registration = atoi(line + strlen(responseBuffer));
+				
+				// Registered to home network or roaming
+				if ((registration == 1) || (registration == 5))
+				{
+					if (status == ON)
+					{
+						// Reconnect on the next poll with a fresh set of attempts
+						linkAttempts = 0;
+						linkPeriod = 0;
+					}
+				}
+				else if (status == GPRS_ON)
+				{
+					// Bearer can't be up without registration
+					status = ON;
+					linkDrops++;
+					linkAttempts = 0;
+					// Reconnect once registered again
+					linkPeriod = linkInterval;
+				}
+			}
+#endif
+#if WISMO228_PING
+			// Ping reply: +WIPPING: <timeout>,<index>,<response time>
+			if (lineStartsWith(line, pingReply))
+			{
+				pingReceived(line + strlen(responseBuffer));
+			}
+#endif
+		}
+	}
+}
+
+#if WISMO228_UDP
+/*******************************************************************************
+* Name: openUdp
+* Description: Create a UDP socket towards a server. Datagrams are exchanged in 
+*							 block mode, module remains in AT command mode.
+*
+* Argument  			Description
+* =========  			===========
+* 1. server				Server name or IP.
+*									Example: www.google.com, 200.200.200.200
+*
+*	2. port					Server UDP port number from 0-65535.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the socket is created or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::openUdp(const char *server, const char *port)
+{
+	bool	success = false;
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		// Local port is assigned by the module
+		uart->print(F("AT+WIPCREATE=1,1,0,\""));
+		uart->print(server);
+		uart->print(F("\","));
+		uart->println(port);
+		
+		uart->setTimeout(MED_TIMEOUT);
+		
+		readFlash(udpOk, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			// Start a new sequence
+			udpSequence = 0;
+			udpLost = 0;
+			success = true;
+		}
+		
+		// Revert to minimum response time	
+		uart->setTimeout(MIN_TIMEOUT);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: closeUdp
+* Description: Close the UDP socket created through openUdp.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the socket is closed or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::closeUdp()
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		success = closePort(WIP_UDP, SOCKET_INDEX);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: sendDatagram
+* Description: Send a datagram through the UDP socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. data					Data to be sent.
+*
+*	2. length				Number of bytes to be sent.
+*
+*	3. acknowledge	If true, data is prefixed with a 4 digit hexadecimal sequence 
+*									number and a comma (example: 002A,) and the server is 
+*									expected to reply with a datagram starting with the same 
+*									sequence number. Unacknowledged datagrams are counted as 
+*									lost (refer to getDatagramLoss).
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the datagram is sent (and acknowledged when 
+*									requested) or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::sendDatagram(const char *data, unsigned int length, 
+														 bool acknowledge)
+{
+	bool	success = false;
+	char	sequence[SEQUENCE_LENGTH + 1];
+	char	reply[RESPONSE_LENGTH_MAX];
+	unsigned	char	digit;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		if (acknowledge)
+		{
+			// Sequence number in hexadecimal, most significant digit first
+			for (digit = 0; digit < (SEQUENCE_LENGTH - 1); digit++)
+			{
+				sequence[digit] = pgm_read_byte_near(hexTable + 
+																	((udpSequence >> (12 - (digit * 4))) & 0x0F));
+			}
+			sequence[SEQUENCE_LENGTH - 1] = ',';
+			sequence[SEQUENCE_LENGTH] = '\0';
+			
+			udpSequence++;
+			
+			if (beginBlock(WIP_UDP, SOCKET_INDEX, length + SEQUENCE_LENGTH))
+			{
+				uart->print(sequence);
+				uart->write((const uint8_t *)data, length);
+				
+				if (endBlock())
+				{
+					// Server echoes the sequence number
+					if (waitForBlock(WIP_UDP, SOCKET_INDEX, reply, 
+													 RESPONSE_LENGTH_MAX - 1, MIN_TIMEOUT))
+					{
+						if (strncmp(reply, sequence, SEQUENCE_LENGTH - 1) == 0)
+						{
+							success = true;
+						}
+					}
+					
+					if (!success)
+					{
+						udpLost++;
+					}
+				}
+			}
+		}
+		else
+		{
+			if (beginBlock(WIP_UDP, SOCKET_INDEX, length))
+			{
+				uart->write((const uint8_t *)data, length);
+				success = endBlock();
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: readDatagram
+* Description: Retrieve a received datagram from the UDP socket without waiting.
+*
+* Argument  			Description
+* =========  			===========
+* 1. data					Location to store the received data.
+*
+*	2. limit				The maximum number of bytes to retrieve.
+*	
+* Return					Description
+* =========				===========
+* 1. count	 			Number of bytes retrieved. 0 if no datagram is pending.
+*
+*******************************************************************************/
+unsigned int	WISMO228::readDatagram(char *data, unsigned int limit)
+{
+	unsigned int	count = 0;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		count = readBlock(WIP_UDP, SOCKET_INDEX, data, limit);
+	}
+	
+	return (count);
+}
+
+/*******************************************************************************
+* Name: getDatagramLoss
+* Description: Number of acknowledged datagrams which were lost since the UDP 
+*							 socket was created.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. lost		 			Number of datagrams without acknowledgement.
+*
+*******************************************************************************/
+unsigned int	WISMO228::getDatagramLoss()
+{
+	return (udpLost);
+}
+#endif
+
+#if WISMO228_MQTT
+/*******************************************************************************
+* Name: mqttConnect
+* Description: Open a persistent socket with a MQTT broker and establish a MQTT 
+*							 3.1.1 session (clean session). Socket data is exchanged in 
+*							 block mode on a socket of its own (MQTT_SOCKET_INDEX), so the 
+*							 session runs alongside HTTP requests and a SMTP session.
+*
+* Argument  			Description
+* =========  			===========
+* 1. server				MQTT broker name or IP.
+*									Example: broker.yourdomain.com, 200.200.200.200
+*
+*	2. port					Broker TCP port number, usually 1883.
+*
+*	3. clientId			Client identifier.
+*
+*	4. username			Username or NULL if not required.
+*
+*	5. password			Password or NULL if not required.
+*
+*	6. keepAlive		Keep alive period in seconds. mqttLoop sends a ping request 
+*									when no packet is sent within this period.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if broker accepted the connection or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttConnect(const char *server, const char *port, 
+														const char *clientId, const char *username, 
+														const char *password, unsigned int keepAlive)
+{
+	bool	success = false;
+	unsigned int	length;
+	unsigned int	offset;
+	unsigned char	flags;
+	unsigned char	index;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		// Protocol name & level, flags, keep alive, client identifier
+		length = sizeof(mqttProtocol) + 1 + 2 + 2 + strlen(clientId);
+		// Clean session
+		flags = 0x02;
+		
+		if (username != NULL)
+		{
+			length += 2 + strlen(username);
+			flags |= 0x80;
+		}
+		
+		if (password != NULL)
+		{
+			length += 2 + strlen(password);
+			flags |= 0x40;
+		}
+		
+		offset = mqttHeader(MQTT_CONNECT, length);
+		
+		// Packet must fit in the packet buffer
+		if ((offset + length) <= MQTT_PACKET_MAX)
+		{
+			for (index = 0; index < sizeof(mqttProtocol); index++)
+			{
+				mqttBuffer[offset++] = pgm_read_byte_near(mqttProtocol + index);
+			}
+			mqttBuffer[offset++] = flags;
+			mqttBuffer[offset++] = keepAlive >> 8;
+			mqttBuffer[offset++] = keepAlive & 0xFF;
+			offset = mqttString(offset, clientId);
+			
+			if (username != NULL)
+			{
+				offset = mqttString(offset, username);
+			}
+			
+			if (password != NULL)
+			{
+				offset = mqttString(offset, password);
+			}
+			
+			if (openPort(MQTT_SOCKET_INDEX, server, port))
+			{
+				mqttKeepAlive = keepAlive;
+				mqttPacketId = 0;
+				
+				if (mqttSend(offset))
+				{
+					if (mqttWaitFor(MQTT_CONNACK, 0, 2))
+					{
+						// Connect return code: connection accepted
+						if (mqttBuffer[1] == 0x00)
+						{
+							socketsOpen |= 1 << MQTT_SOCKET_INDEX;
+							success = true;
+						}
+					}
+				}
+				
+				if (!success)
+				{
+					closePort(WIP_TCP_CLIENT, MQTT_SOCKET_INDEX);
+				}
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttPublish
+* Description: Publish a message to a topic.
+*
+* Argument  			Description
+* =========  			===========
+* 1. topic				Topic name.
+*
+*	2. payload			Message to be published.
+*
+*	3. qos					Quality of service: 0 (at most once) or 1 (at least once).
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the message is sent (and acknowledged by the 
+*									broker for QoS 1) or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttPublish(const char *topic, const char *payload, 
+														unsigned char qos)
+{
+	bool	success = false;
+	unsigned int	length;
+	unsigned int	offset;
+	unsigned int	payloadLength;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if ((status == GPRS_ON) && (qos <= 1))
+	{
+		payloadLength = strlen(payload);
+		length = 2 + strlen(topic) + payloadLength;
+		
+		if (qos == 1)
+		{
+			// Packet identifier
+			length += 2;
+		}
+		
+		offset = mqttHeader(MQTT_PUBLISH | (qos << 1), length);
+		
+		// Packet must fit in the packet buffer
+		if ((offset + length) <= MQTT_PACKET_MAX)
+		{
+			offset = mqttString(offset, topic);
+			
+			if (qos == 1)
+			{
+				// Packet identifier 0 is not allowed
+				if (++mqttPacketId == 0)	mqttPacketId++;
+				mqttBuffer[offset++] = mqttPacketId >> 8;
+				mqttBuffer[offset++] = mqttPacketId & 0xFF;
+			}
+			
+			memcpy(&mqttBuffer[offset], payload, payloadLength);
+			offset += payloadLength;
+			
+			if (mqttSend(offset))
+			{
+				if (qos == 0)
+				{
+					success = true;
+				}
+				else
+				{
+					success = mqttWaitFor(MQTT_PUBACK, mqttPacketId, 2);
+				}
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttSubscribe
+* Description: Subscribe to a topic. Messages published to the topic are passed 
+*							 to the function registered through setMqttCallback.
+*
+* Argument  			Description
+* =========  			===========
+* 1. topic				Topic filter.
+*
+*	2. qos					Maximum quality of service: 0 or 1.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the subscription is granted or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttSubscribe(const char *topic, unsigned char qos)
+{
+	bool	success = false;
+	unsigned int	length;
+	unsigned int	offset;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if ((status == GPRS_ON) && (qos <= 1))
+	{
+		// Packet identifier, topic filter, requested QoS
+		length = 2 + 2 + strlen(topic) + 1;
+		
+		offset = mqttHeader(MQTT_SUBSCRIBE, length);
+		
+		// Packet must fit in the packet buffer
+		if ((offset + length) <= MQTT_PACKET_MAX)
+		{
+			// Packet identifier 0 is not allowed
+			if (++mqttPacketId == 0)	mqttPacketId++;
+			mqttBuffer[offset++] = mqttPacketId >> 8;
+			mqttBuffer[offset++] = mqttPacketId & 0xFF;
+			offset = mqttString(offset, topic);
+			mqttBuffer[offset++] = qos;
+			
+			if (mqttSend(offset))
+			{
+				if (mqttWaitFor(MQTT_SUBACK, mqttPacketId, 3))
+				{
+					// Return code 0x80 indicates failure
+					if ((unsigned char)mqttBuffer[2] != 0x80)
+					{
+						success = true;
+					}
+				}
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttPing
+* Description: Send a ping request to the broker and wait for it's response.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the broker responded or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttPing()
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		if (mqttSend(mqttHeader(MQTT_PINGREQ, 0)))
+		{
+			success = mqttWaitFor(MQTT_PINGRESP, 0, 0);
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttLoop
+* Description: Process packets pushed by the broker and keep the session alive. 
+*							 Call this frequently from the sketch loop.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns false if the broker no longer responds or true if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttLoop()
+{
+	bool	success = false;
+	unsigned char	type;
+	unsigned int	length;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		success = true;
+		
+		// Retrieve all pending packets without waiting
+		while (mqttReadPacket(&type, &length, 0))
+		{
+			mqttReceived(type, length);
+		}
+		
+		// Keep alive period expired without any packet sent
+		if ((mqttKeepAlive > 0) && 
+				((millis() - mqttLastSent) >= ((unsigned long)mqttKeepAlive * 1000)))
+		{
+			success = mqttPing();
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: mqttDisconnect
+* Description: End the MQTT session and close the socket with the broker.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the socket is closed or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::mqttDisconnect()
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		mqttSend(mqttHeader(MQTT_DISCONNECT, 0));
+		success = closePort(WIP_TCP_CLIENT, MQTT_SOCKET_INDEX);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: setMqttCallback
+* Description: Register the handler of messages published by the broker.
+*
+* Argument  			Description
+* =========  			===========
+* 1. messageFunction	Handler receiving the topic & payload as strings.
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setMqttCallback(void (*messageFunction)(const char *topic, 
+																												const char *payload))
+{
+	mqttFunctionPtr = messageFunction;
+}
+#endif
+
+#if WISMO228_FTP
+/*******************************************************************************
+* Name: ftpUpload
+* Description: Upload a file to a FTP server in a single session. File content 
+*							 is streamed from a user data source (SD card, external flash, 
+*							 etc.) so the file does not need to fit in RAM.
+*
+* Argument  			Description
+* =========  			===========
+* 1. server				FTP server name or IP.
+*									Example: ftp.yourdomain.com, 200.200.200.200
+*
+*	2. port					FTP server port number, usually 21.
+*
+*	3. username			FTP account username.
+*
+*	4. password			Corresponding password for the username.
+*
+*	5. filename			Name (and path) of the file on the server.
+*
+*	6. source				Function filling the data buffer with up to size bytes of the
+*									file and returning the number of bytes filled. Returns 0 
+*									when the end of the file is reached.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if the file is uploaded or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::ftpUpload(const char *server, const char *port, 
+													const char *username, const char *password, 
+													const char *filename, 
+													unsigned int (*source)(char *data, unsigned int size))
+{
+	bool	success = false;
+	char	data[FTP_CHUNK_MAX];
+	unsigned int	count;
+	unsigned int	index;
+	unsigned long	start;
+	unsigned long	bytes = 0;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If currently attach to GPRS
+	if (status == GPRS_ON)
+	{
+		// Open a FTP session
+		uart->print(F("AT+WIPCREATE=4,1,\""));
+		uart->print(server);
+		uart->print(F("\","));
+		uart->print(port);
+		uart->print(F(",\""));
+		uart->print(username);
+		uart->print(F("\",\""));
+		uart->print(password);
+		uart->println(F("\""));
+		
+		// Log in to the server takes a few round trips
+		uart->setTimeout(MAX_TIMEOUT);
+		
+		readFlash(ftpOk, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			// Request to store the file
+			uart->print(F("AT+WIPFILE=4,1,2,\""));
+			uart->print(filename);
+			uart->println(F("\""));
+			
+			readFlash(connectOk, responseBuffer);
+			
+			if (uart->find(responseBuffer))
+			{
+				start = millis();
+				
+				while ((count = source(data, FTP_CHUNK_MAX)) > 0)
+				{
+					for (index = 0; index < count; index++)
+					{
+						// End of transfer & escape characters within data are escaped
+						if ((data[index] == ETX) || (data[index] == DLE))
+						{
+							uart->write(DLE);
+						}
+						uart->write(data[index]);
+					}
+					
+					bytes += count;
+				}
+				
+				// End of file
+				uart->write(ETX);
+				
+				readFlash(ok, responseBuffer);
+				
+				if (uart->find(responseBuffer))
+				{
+					// Measurement of a failed upload is discarded
+					ftpBytes = bytes;
+					ftpDuration = millis() - start;
+					success = true;
+				}
+			}
+		}
+		
+		// Revert to minimum response time	
+		uart->setTimeout(MIN_TIMEOUT);
+		
+		// Close the FTP session
+		closePort(WIP_FTP, SOCKET_INDEX);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: getFtpThroughput
+* Description: Throughput of the last successful FTP upload.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. throughput		Throughput in bytes per second.
+*
+*******************************************************************************/
+unsigned long	WISMO228::getFtpThroughput()
+{
+	unsigned long	throughput = 0;
+	unsigned long	remainder;
+	
+	if (ftpDuration > 0)
+	{
+		// Whole & fractional bytes per ms are scaled separately, ftpBytes * 1000 
+		// overflows above 4 MB
+		throughput = (ftpBytes / ftpDuration) * 1000;
+		remainder = ftpBytes % ftpDuration;
+		
+		if (remainder <= (0xFFFFFFFFUL / 1000))
+		{
+			throughput += (remainder * 1000) / ftpDuration;
+		}
+		else
+		{
+			// Upload took over an hour, 1 ms resolution is not needed
+			throughput += remainder / (ftpDuration / 1000);
+		}
+	}
+	
+	return (throughput);
+}
+#endif
+
+#if WISMO228_GPRS
+/*******************************************************************************
+* Name: clearDnsCache
+* Description: Forget all cached server addresses.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::clearDnsCache()
+{
+	unsigned	char	index;
+	
+	for (index = 0; index < DNS_CACHE_SIZE; index++)
+	{
+		dnsCache[index].address[0] = '\0';
+	}
+}
+#endif
+
+#if WISMO228_CLOCK
+/*******************************************************************************
+* Name: getClock
+* Description: Retrieve the WISMO228 module clock.
+*
+* Argument  			Description
+* =========  			===========
+* 1. clock     		Clock in YY/MM/DD,HH:MM:SS*ZZ format
+*									ZZ represent time difference between local & GMT time 
+*									expressed in quarters of an hour. *ZZ has a range of 
+*									-48 to +48. 
+*									Example: 11/11/16,00:56:24+32 (GMT+8 local time).
+*	
+* Return					Description
+* =========				===========
+* 1. success 			True if clock is retrieved successfully or false if otherwise. 
+*
+*******************************************************************************/
+bool WISMO228::getClock(char *clock)
+{
+	bool success = false;
+	unsigned	char	clockCount;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	// If WISMO228 is on
+	if (status == ON)
+	{
+		// Request current clock
+		uart->println(F("AT+CCLK?"));
+		
+		readFlash(clockOk, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			if (waitForReply(CLOCK_COUNT_MAX, MIN_TIMEOUT))
+			{
+				for (clockCount = CLOCK_COUNT_MAX; clockCount > 0; clockCount--)
+				{
+					// Retrieve clock
+					*clock++ = uart->read();
+				}
+				
+				// Terminate the clock string
+				*clock = '\0';
+				
+				// Expecting an "OK" response
+				readFlash(ok, responseBuffer);
+				
+				if (uart->find(responseBuffer))
+				{
+					success = true;
+				}
+			}
+		}
+	}
+	
+	return (success);
+}	
+
+/*******************************************************************************
+* Name: setClock
+* Description: Set the WISMO228 module clock.
+*
+* Argument  			Description
+* =========  			===========
+* 1. clock     		Clock in YY/MM/DD,HH:MM:SS*ZZ format
+*									ZZ represent time difference between local & GMT time 
+*									expressed in quarters of an hour. *ZZ has a range of 
+*									-48 to +48. 
+*									Example: 11/11/16,00:56:24+32 (GMT+8 local time).
+*	
+* Return					Description
+* =========				===========
+* 1. success 			True if clock is set successfully or false if otherwise. 
+*
+*******************************************************************************/
+bool WISMO228::setClock(const char *clock)
+{
+	bool success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == ON)
+	{
+		// Check for correct clock string length
+		if (strlen(clock) == CLOCK_COUNT_MAX)
+		{
+			uart->print(F("AT+CCLK=\""));
+			uart->print(clock);
+			uart->print(F("\"\r\n"));
+			
+			// Expecting an "OK" response
+			readFlash(ok, responseBuffer);
+			
+			if (uart->find(responseBuffer))
+			{
+				success = true;
+				
+				// Local timebase follows the new clock without learning drift
+				if (timeSynced)
+				{
+					timeSynced = false;
+					updateTime();
+				}
+			}
+		}
+	}
+	
+	return (success);
+}	
+
+/*******************************************************************************
+* Name: syncTime
+* Description: Synchronize the local timebase with the WISMO228 module clock. 
+*							 Timestamps are then served from millis (getTime) without 
+*							 accessing the module. When a resync interval is given, poll 
+*							 resynchronizes periodically and learns the drift of the local 
+*							 oscillator against the module clock.
+*
+* Argument  			Description
+* =========  			===========
+* 1. network			True to let the network update the module clock & time zone 
+*									(NITZ, AT+CTZU=1) if supported by the operator.
+*
+*	2. interval			Resync interval in ms. 0 disables periodic resync.
+*	
+* Return					Description
+* =========				===========
+* 1. success 			True if the timebase is synchronized or false if otherwise. 
+*
+*******************************************************************************/
+bool	WISMO228::syncTime(bool network, unsigned long interval)
+{
+	bool	success = false;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == ON)
+	{
+		timeInterval = interval;
+		
+		if (network)
+		{
+			// Automatic time & time zone update from network
+			uart->println(F("AT+CTZU=1"));
+			
+			readFlash(ok, responseBuffer);
+			
+			findReply(TIMEOUT_LOCAL, responseBuffer);
+		}
+		
+		// A fresh synchronization says nothing about drift
+		timeSynced = false;
+		
+		success = updateTime();
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: getTime
+* Description: Retrieve current time from the local timebase.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. time 				UTC time in seconds since 01-01-1970 (Unix time) or 0 if the
+*									timebase is not synchronized (refer to syncTime).
+*
+*******************************************************************************/
+unsigned long	WISMO228::getTime()
+{
+	unsigned	long	time = 0;
+	unsigned	long	elapsed;
+	
+	if (timeSynced)
+	{
+		elapsed = (millis() - timeMillis) / 1000;
+		
+		// Drift is in parts per million
+		time = timeEpoch + elapsed + ((long)(elapsed / 100) * timeDrift) / 10000;
+	}
+	
+	return (time);
+}
+
+/*******************************************************************************
+* Name: getTimeZone
+* Description: Retrieve time zone of the module clock at the last 
+*							 synchronization.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. zone 				Time difference between local & GMT time expressed in 
+*									quarters of an hour (-48 to +48).
+*
+*******************************************************************************/
+int	WISMO228::getTimeZone()
+{
+	return (timeZone);
+}
+#endif
+
+/*******************************************************************************
+* Name: getRssi
+* Description: Retrieve the WISMO228 module RSSI value in dBm.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. rssi 				RSSI value in dBm. 
+*
+*******************************************************************************/
+int	WISMO228::getRssi()
+{
+	int	rssi = 0;
+	unsigned	char	ber;
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == ON)
+	{
+		if (!readSignal(&rssi, &ber))
+		{
+			rssi = 0;
+		}
+	}
+
+	return (rssi);
+}
+
+/*******************************************************************************
+* Name: setSignalMonitor
+* Description: Configure the background signal quality monitor. When enabled, 
+*							 poll samples RSSI & BER periodically and maintains their moving
+*							 averages and RSSI trend.
+*
+* Argument  			Description
+* =========  			===========
+* 1. interval			Sampling interval in ms. 0 disables the monitor.
+*
+*	2. threshold		Minimum average RSSI in dBm for non urgent transmissions 
+*									(refer to signalAllows).
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setSignalMonitor(unsigned long interval, int threshold)
+{
+	signalInterval = interval;
+	signalThreshold = threshold;
+	signalSamples = 0;
+	// Sample on the next poll
+	signalSampled = millis() - interval;
+}
+
+/*******************************************************************************
+* Name: getSignalAverage
+* Description: Moving average of RSSI sampled by the signal quality monitor.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. rssi 				Average RSSI in dBm or 0 if no sample is available.
+*
+*******************************************************************************/
+int	WISMO228::getSignalAverage()
+{
+	int	rssi = 0;
+	
+	if (signalSamples > 0)
+	{
+		rssi = signalAverage / SIGNAL_SCALE;
+	}
+	
+	return (rssi);
+}
+
+/*******************************************************************************
+* Name: getSignalTrend
+* Description: Trend of RSSI sampled by the signal quality monitor, being the 
+*							 difference between the recent and the long term average.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. trend 				Trend in dB. Positive when signal is improving.
+*
+*******************************************************************************/
+int	WISMO228::getSignalTrend()
+{
+	return ((signalRecent - signalAverage) / SIGNAL_SCALE);
+}
+
+/*******************************************************************************
+* Name: getBer
+* Description: Moving average of bit error rate sampled by the signal quality 
+*							 monitor.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. ber	 				Average BER as RXQUAL 0-7 (lower is better) or 99 if not 
+*									known.
+*
+*******************************************************************************/
+unsigned char	WISMO228::getBer()
+{
+	unsigned	char	ber = 99;
+	
+	if (berSamples > 0)
+	{
+		ber = (berAverage + (SIGNAL_SCALE / 2)) / SIGNAL_SCALE;
+	}
+	
+	return (ber);
+}
+
+/*******************************************************************************
+* Name: signalAllows
+* Description: Scheduling hook deciding whether a transmission should take 
+*							 place now. Non urgent transmissions are deferred while average 
+*							 signal is below the threshold given to setSignalMonitor, as 
+*							 they take longer and retry more at poor signal.
+*
+* Argument  			Description
+* =========  			===========
+* 1. urgent				True if the transmission must not be deferred.
+*	
+* Return					Description
+* =========				===========
+* 1. allowed 			Returns true if the transmission should take place now or 
+*									false if it should be deferred. Always true when the monitor 
+*									is disabled or has no sample yet.
+*
+*******************************************************************************/
+bool	WISMO228::signalAllows(bool urgent)
+{
+	bool	allowed = true;
+	
+	if (!urgent && (signalInterval > 0) && (signalSamples > 0))
+	{
+		if (getSignalAverage() < signalThreshold)
+		{
+			allowed = false;
+		}
+	}
+	
+	return (allowed);
+}
+
+/*******************************************************************************
+* Name: getTimeout
+* Description: Response timeout currently applied to a class of commands. It is
+*							 learned from observed response times as smoothed average plus 4 
+*							 times the smoothed deviation, bounded by TIMEOUT_FLOOR and the 
+*							 ceiling of the class.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					TIMEOUT_LOCAL (module only AT commands), TIMEOUT_NETWORK 
+*									(network registration & GPRS bearer), TIMEOUT_SOCKET (socket 
+*									open) or TIMEOUT_SERVER (server reply).
+*	
+* Return					Description
+* =========				===========
+* 1. timeout 			Timeout in ms.
+*
+*******************************************************************************/
+unsigned int	WISMO228::getTimeout(timeoutClass_t type)
+{
+	unsigned	long	timeout;
+	
+	timeout = latency[type].average + (4UL * latency[type].deviation);
+	
+	if (timeout < TIMEOUT_FLOOR)
+	{
+		timeout = TIMEOUT_FLOOR;
+	}
+	else if (timeout > latency[type].ceiling)
+	{
+		timeout = latency[type].ceiling;
+	}
+	
+	return (timeout);
+}
+
+/*******************************************************************************
+* Name: setRetryPolicy
+* Description: Configure how bearer start, socket open and SMS sending are 
+*							 retried. Delay between attempts starts at the base delay and 
+*							 is multiplied by the backoff factor after every attempt, plus a
+*							 random jitter so that modules do not retry in lock step.
+*
+* Argument  			Description
+* =========  			===========
+* 1. policy				Retry policy or NULL to revert to the default policy 
+*									(RETRY_ATTEMPTS, RETRY_DELAY, RETRY_FACTOR, RETRY_JITTER & 
+*									RETRY_DEADLINE).
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setRetryPolicy(const retryPolicy_t *policy)
+{
+	if (policy != NULL)
+	{
+		retryPolicy = *policy;
+	}
+	else
+	{
+		retryPolicy.attempts = RETRY_ATTEMPTS;
+		retryPolicy.baseDelay = RETRY_DELAY;
+		retryPolicy.factor = RETRY_FACTOR;
+		retryPolicy.jitter = RETRY_JITTER;
+		retryPolicy.deadline = RETRY_DEADLINE;
+	}
+	
+	// At least a single attempt
+	if (retryPolicy.attempts == 0)
+	{
+		retryPolicy.attempts = 1;
+	}
+}
+
+/*******************************************************************************
+* Name: setIdleCallback
+* Description: Set a function called repeatedly while waiting between retry 
+*							 attempts, so that the sketch can keep up with other tasks.
+*
+* Argument  			Description
+* =========  			===========
+* 1. idleFunction	Function to call or NULL for none.
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::setIdleCallback(void (*idleFunction)(void))
+{
+	idleFunctionPtr = idleFunction;
+}
+
+/*******************************************************************************
+* Name: cancelRetry
+* Description: Give up the retry attempts in progress. Called from the idle 
+*							 callback, the waiting function (openGPRS, sendSms or any 
+*							 function opening a socket) returns with a failure as soon as 
+*							 the callback returns instead of blocking until the retry 
+*							 policy runs out.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*	
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::cancelRetry()
+{
+	retryCancelled = true;
+}
+
+#if WISMO228_CLOCK
+/*******************************************************************************
+* Name: updateTime
+* Description: Synchronize the local timebase with the module clock. If the 
+*							 timebase is already synchronized, the difference to the module 
+*							 clock is used to correct the drift estimate.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the timebase is synchronized or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::updateTime()
+{
+	bool	success = false;
+	char	clock[CLOCK_COUNT_MAX + 1];
+	unsigned	long	epoch;
+	unsigned	long	elapsed;
+	long	error;
+	
+	if (getClock(clock))
+	{
+		epoch = clockToEpoch(clock);
+		
+		if (epoch > 0)
+		{
+			if (timeSynced)
+			{
+				elapsed = (millis() - timeMillis) / 1000;
+				
+				// Seconds the local timebase is behind the module clock
+				error = (long)(epoch - getTime());
+				
+				// Larger error is a clock change rather than drift
+				if ((elapsed >= TIME_DRIFT_PERIOD) && (error >= -TIME_STEP_MAX) && 
+						(error <= TIME_STEP_MAX))
+				{
+					// Damped correction as the module clock has a 1 s resolution
+					timeDrift += ((error * 1000000L) / (long)elapsed) / 2;
+					timeDrift = constrain(timeDrift, -TIME_DRIFT_MAX, TIME_DRIFT_MAX);
+				}
+			}
+			
+			timeEpoch = epoch;
+			timeMillis = millis();
+			timeChecked = timeMillis;
+			timeSynced = true;
+			success = true;
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: clockToEpoch
+* Description: Convert a module clock string to Unix time.
+*
+* Argument  			Description
+* =========  			===========
+* 1. clock				Clock in YY/MM/DD,HH:MM:SS*ZZ format.
+*
+* Return					Description
+* =========				===========
+* 1. epoch				UTC time in seconds since 01-01-1970 or 0 if the clock string
+*									is invalid.
+*
+*******************************************************************************/
+unsigned long	WISMO228::clockToEpoch(const char *clock)
+{
+	unsigned	long	epoch = 0;
+	unsigned	int	year;
+	unsigned	char	month;
+	unsigned	char	day;
+	long	days;
+	
+	if ((strlen(clock) == CLOCK_COUNT_MAX) && 
+			((clock[17] == '+') || (clock[17] == '-')))
+	{
+		year = 2000 + atoi(clock);
+		month = atoi(clock + 3);
+		day = atoi(clock + 6);
+		
+		if ((month >= 1) && (month <= 12) && (day >= 1) && (day <= 31))
+		{
+			// Count years from March so that leap day is the last day of a year
+			if (month <= 2)
+			{
+				year--;
+				month += 12;
+			}
+			
+			days = 365L * year + (year / 4) - (year / 100) + (year / 400) + 
+						 ((153 * (month - 3) + 2) / 5) + day - 1 - 719468L;
+			
+			epoch = days * 86400UL;
+			epoch += atoi(clock + 9) * 3600UL;
+			epoch += atoi(clock + 12) * 60UL;
+			epoch += atoi(clock + 15);
+			
+			// Time zone in quarters of an hour, convert local time to UTC
+			timeZone = atoi(clock + 18);
+			
+			if (clock[17] == '-')
+			{
+				timeZone = -timeZone;
+			}
+			
+			epoch -= timeZone * 900L;
+		}
+	}
+	
+	return (epoch);
+}
+#endif
+
+/*******************************************************************************
+* Name: readSignal
+* Description: Retrieve RSSI & BER from the WISMO228 module.
+*
+* Argument  			Description
+* =========  			===========
+* 1. rssi					RSSI value in dBm.
+*
+*	2. ber					BER as RXQUAL 0-7 or 99 if not known (no ongoing traffic).
+*
+* Return					Description
+* =========				===========
+* 1. success			True if RSSI is known or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::readSignal(int *rssi, unsigned char *ber)
+{
+	bool	success = false;
+	int	value;
+	
+	uart->println(F("AT+CSQ"));
+	
+	readFlash(rssiCheck, responseBuffer);
+	
+	// Reply: +CSQ: <rssi>,<ber>
+	if (uart->find(responseBuffer))
+	{
+		value = uart->parseInt();
+		
+		// 99 indicates unknown RSSI
+		if ((value >= 0) && (value <= 31) && (uart->read() == ','))
+		{
+			*rssi = rssiToDbm(value);
+			
+			value = uart->parseInt();
+			
+			if ((value >= 0) && (value <= 7))
+			{
+				*ber = value;
+			}
+			else
+			{
+				*ber = 99;
+			}
+			
+			// Expecting an "OK" response
+			readFlash(ok, responseBuffer);
+			
+			if (uart->find(responseBuffer))
+			{
+				success = true;
+			}
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: sampleSignal
+* Description: Take a signal quality sample and update the moving averages. 
+*							 Long term averages weigh the new sample by 1/8 and the recent 
+*							 RSSI average weighs it by 1/2. Averages are kept scaled by 
+*							 SIGNAL_SCALE to retain fractions.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::sampleSignal()
+{
+	int	rssi;
+	unsigned	char	ber;
+	
+	if (readSignal(&rssi, &ber))
+	{
+		rssi *= SIGNAL_SCALE;
+		
+		// First sample seeds the averages
+		if (signalSamples == 0)
+		{
+			signalAverage = rssi;
+			signalRecent = rssi;
+		}
+		else
+		{
+			signalAverage += (rssi - signalAverage) / 8;
+			signalRecent += (rssi - signalRecent) / 2;
+		}
+		
+		if (signalSamples < 0xFF)	signalSamples++;
+		
+		if (ber != 99)
+		{
+			if (berSamples == 0)
+			{
+				berAverage = ber * SIGNAL_SCALE;
+			}
+			else
+			{
+				berAverage += ((int)(ber * SIGNAL_SCALE) - berAverage) / 8;
+			}
+			
+			if (berSamples < 0xFF)	berSamples++;
+		}
+	}
+}
+
+/*******************************************************************************
+* Name: rssiToDbm
+* Description: Convert RSSI value into dBm.
+*
+* Argument  			Description
+* =========  			===========
+* 1. rssi					RSSI value in decimal 0-31.		
+*	
+* Return					Description
+* =========				===========
+* 1. rssi 				RSSI value in dBm. 
+*
+*******************************************************************************/
+int	WISMO228::rssiToDbm(int	rssi)
+{
+	rssi = (rssi*2) + MINIMUM_SIGNAL_DBM;
+
+	return (rssi);				
+}
+
+/*******************************************************************************
+* Name: waitForReply
+* Description: Wait for certain number of charaters from WISMO228 module within 
+*							 a certain time frame.
+*
+* Argument  			Description
+* =========  			===========
+* 1. count				Number of expected characters from WISMO228 module.				
+*
+*	2. period				Time frame to wait for the reply from WISMO228 module in ms.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the expected number of characters from the WISMO228 
+*									module is received within the stipulated time frame or false 
+*									if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::waitForReply(unsigned char count, long period)
+{
+	bool	success = false;
+	unsigned long	timeout;
+	
+	timeout = millis() + period;
+	
+	while ((uart->available() < count) && (timeout > millis()));
+	
+	if ((uart->available() >= count) && (timeout > millis()))
+	{
+		success = true;
+	}
+	
+	return (success);
+}
+
+#if WISMO228_SMS
+/*******************************************************************************
+* Name: submitSms
+* Description: Submit a SMS to the network. Waiting for the message prompt is 
+*							 retried according to the retry policy.
+*
+* Argument  			Description
+* =========  			===========
+* 1. recipient    Phone number of the recipient.
+*
+* 2. message			Message of length not more than 160 characters.		
+*
+* Return					Description
+* =========				===========
+* 1. success 			Returns true if SMS is successfully sent and false if
+*									otherwise.
+*
+*******************************************************************************/		
+bool	WISMO228::submitSms(const char *recipient, const char *message)
+{
+	bool success = false;
+	bool	prompt = false;
+	unsigned char attempt;
+	unsigned long start;
+	
+	start = millis();
+	
+	// Only retry while the message is not yet submitted to avoid sending it
+	// twice
+	for (attempt = 1; ; attempt++)
+	{
+		uart->print(F("AT+CMGS=\""));
+		uart->print(recipient);
+		uart->println(F("\""));
+		
+		// Writing SMS takes more time compared to other task
+		uart->setTimeout(MED_TIMEOUT);
+		
+		readFlash(writeCursor, responseBuffer);
+		
+		// Wait for SMS writing prompt (cursor)
+		if (uart->find(responseBuffer))
+		{
+			prompt = true;
+			break;
+		}
+		
+		// Cancel the message in case the prompt shows up late
+		uart->write(27);
+		
+		if (!retryWait(attempt, start))	break;
+	}
+	
+	if (prompt)
+	{
+		// Write the message
+		uart->print(message);
+		// End the message
+		uart->write(26);
+		
+		readFlash(smsSendOk, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			// Revert back to normal reply timeout
+			uart->setTimeout(MIN_TIMEOUT);
+			
+			if (waitForReply(3, MIN_TIMEOUT))
+			{
+				// Read out all SMS ID
+				while ((char)uart->read() != '\r');
+				
+				readFlash(ok, responseBuffer);
+				
+				if (uart->find(responseBuffer))
+				{
+					success = true;
+				}
+			}
+		}
+	}
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	return (success);	
+}
+
+/*******************************************************************************
+* Name: cleanupSms
+* Description: Delete read & sent messages if the SMS storage occupancy is at 
+*							 or above the cleanup threshold.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::cleanupSms()
+{
+	unsigned	char	used;
+	unsigned	char	total;
+	
+	if (getSmsStorage(&used, &total))
+	{
+		if ((total > 0) && (((unsigned int)used * 100) >= 
+												((unsigned int)smsCleanup * total)))
+		{
+			uart->println(F("AT+CMGD=1,3"));
+			
+			readFlash(ok, responseBuffer);
+			
+			// Deleting many messages takes longer
+			uart->setTimeout(MED_TIMEOUT);
+			uart->find(responseBuffer);
+			uart->setTimeout(MIN_TIMEOUT);
+		}
+	}
+}
+
+/*******************************************************************************
+* Name: findSender
+* Description: Look up a sender in the whitelist.
+*
+* Argument  			Description
+* =========  			===========
+* 1. sender				Phone number of the sender with or without the "+" prefix.
+*
+* Return					Description
+* =========				===========
+* 1. slot					Whitelist slot of the sender or -1 if not found.
+*
+*******************************************************************************/
+int	WISMO228::findSender(const char *sender)
+{
+	int	found = -1;
+	uint32_t	hash;
+	uint32_t	entry;
+	unsigned	char	slot;
+	unsigned	char	probe;
+	
+	hash = senderHash(sender);
+	
+	for (probe = 0; probe < whitelistSlots; probe++)
+	{
+		slot = (hash + probe) % whitelistSlots;
+		entry = eeprom_read_dword(whitelistSlot(slot));
+		
+		if (entry == hash)
+		{
+			found = slot;
+			break;
+		}
+		
+		// End of the probe sequence
+		if (entry == WHITELIST_EMPTY)	break;
+	}
+	
+	return (found);
+}
+
+/*******************************************************************************
+* Name: senderHash
+* Description: Hash (32-bit FNV-1a) of a sender phone number as stored in the 
+*							 whitelist. A sender is identified by its hash alone, 32 bits
+*							 keep an unknown number from matching an authorised one.
+*
+* Argument  			Description
+* =========  			===========
+* 1. sender				Phone number of the sender with or without the "+" prefix.
+*
+* Return					Description
+* =========				===========
+* 1. hash					Hash value, never WHITELIST_EMPTY or WHITELIST_REMOVED.
+*
+*******************************************************************************/
+uint32_t	WISMO228::senderHash(const char *sender)
+{
+	uint32_t	hash = 2166136261UL;
+	
+	// Received SMS sender comes without the "+" prefix
+	if (*sender == '+')	sender++;
+	
+	while (*sender != '\0')
+	{
+		hash ^= (unsigned char)*sender++;
+		hash *= 16777619UL;
+	}
+	
+	// Values reserved to mark slots
+	if ((hash == WHITELIST_EMPTY) || (hash == WHITELIST_REMOVED))
+	{
+		hash = 1;
+	}
+	
+	return (hash);
+}
+
+/*******************************************************************************
+* Name: whitelistSlot
+* Description: EEPROM address of a whitelist slot.
+*
+* Argument  			Description
+* =========  			===========
+* 1. slot					Whitelist slot.
+*
+* Return					Description
+* =========				===========
+* 1. address			EEPROM address of the slot.
+*
+*******************************************************************************/
+uint32_t	*WISMO228::whitelistSlot(unsigned char slot)
+{
+	return ((uint32_t *)(size_t)whitelistAddress + slot);
+}
+#endif
+
+/*******************************************************************************
+* Name: storedConfig
+* Description: Configuration record kept in EEPROM once the power up 
+*							 configuration is saved in the module profile.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. record				Signature with the saved configuration flags.
+*
+*******************************************************************************/
+unsigned int	WISMO228::storedConfig()
+{
+	unsigned	int	record;
+	
+	record = CONFIG_SIGNATURE | CONFIG_ECHO_OFF | CONFIG_SMS;
+	
+	// RING pin setup is only part of the SMS configuration if used
+	if (_ringPin != NC)
+	{
+		record |= CONFIG_RING;
+	}
+	
+	return (record);
+}
+
+/*******************************************************************************
+* Name: queueCommand
+* Description: Add a command to the command queue, to be sent with sendQueue.
+*
+* Argument  			Description
+* =========  			===========
+* 1. command			Command stored in flash memory without the "AT" prefix.
+*									Example: F("+CMGF=1")
+*
+*	2. argument			String argument appended to the command in quotes or NULL
+*									for none.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::queueCommand(const __FlashStringHelper *command, 
+														 const char *argument)
+{
+	if (commandCount < COMMAND_QUEUE_MAX)
+	{
+		commandQueue[commandCount].command = command;
+		commandQueue[commandCount].argument = argument;
+		commandCount++;
+	}
+}
+
+/*******************************************************************************
+* Name: sendQueue
+* Description: Send all queued commands without waiting for the reply of each 
+*							 command and match the replies in order. The queue is emptied.
+*
+* Argument  			Description
+* =========  			===========
+* 1. joined				True to send the commands as a single command line separated 
+*									by ";" (single final reply) or false to send them back to 
+*									back as separate command lines (a final reply each).
+*
+* Return					Description
+* =========				===========
+* 1. success			True if every command replied "OK" or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::sendQueue(bool joined)
+{
+	bool	success = true;
+	char	line[LINE_LENGTH_MAX];
+	unsigned	char	index;
+	unsigned	char	replies;
+	unsigned	long	start;
+	
+	uart->print(F("AT"));
+	
+	for (index = 0; index < commandCount; index++)
+	{
+		if (index > 0)
+		{
+			if (joined)
+			{
+				uart->write(';');
+			}
+			else
+			{
+				uart->print(F("\r\nAT"));
+			}
+		}
+		
+		uart->print(commandQueue[index].command);
+		
+		if (commandQueue[index].argument != NULL)
+		{
+			uart->write('"');
+			uart->print(commandQueue[index].argument);
+			uart->write('"');
+		}
+	}
+	
+	uart->println();
+	
+	replies = joined ? 1 : commandCount;
+	commandCount = 0;
+	
+	uart->setTimeout(getTimeout(TIMEOUT_LOCAL));
+	
+	start = millis();
+	
+	// Final reply of each command line is either "OK" or an error
+	while ((replies > 0) && ((millis() - start) < getTimeout(TIMEOUT_LOCAL)))
+	{
+		if (readLine(line, LINE_LENGTH_MAX))
+		{
+			readFlash(ok, responseBuffer);
+			
+			if (strcmp(line, responseBuffer) == 0)
+			{
+				learnLatency(TIMEOUT_LOCAL, millis() - start);
+				replies--;
+				start = millis();
+			}
+			else
+			{
+				readFlash(errorReply, responseBuffer);
+				
+				if (strstr(line, responseBuffer) != NULL)
+				{
+					success = false;
+					replies--;
+					start = millis();
+				}
+			}
+		}
+	}
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	return (success && (replies == 0));
+}
+
+/*******************************************************************************
+* Name: retryWait
+* Description: Decide whether a failed attempt is to be retried according to 
+*							 the retry policy and wait out the backoff delay.
+*
+* Argument  			Description
+* =========  			===========
+* 1. attempt			Number of attempts made so far.
+*
+*	2. start				Time (millis) the first attempt started.
+*
+* Return					Description
+* =========				===========
+* 1. retry				True if another attempt is to be made or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::retryWait(unsigned char attempt, unsigned long start)
+{
+	bool	retry = false;
+	unsigned	long	period;
+	unsigned	long	waitStart;
+	
+	// Cancellation only applies to the attempts in progress
+	if (attempt == 1)
+	{
+		retryCancelled = false;
+	}
+	
+	if ((attempt < retryPolicy.attempts) && !retryCancelled)
+	{
+		period = retryPeriod(attempt);
+		
+		// Next attempt must start before the deadline
+		if ((retryPolicy.deadline == 0) || 
+				((millis() - start + period) < retryPolicy.deadline))
+		{
+			waitStart = millis();
+			
+			while (((millis() - waitStart) < period) && !retryCancelled)
+			{
+				if (idleFunctionPtr != NULL)
+				{
+					idleFunctionPtr();
+				}
+			}
+			
+			retry = !retryCancelled;
+		}
+	}
+	
+	return (retry);
+}
+
+/*******************************************************************************
+* Name: retryPeriod
+* Description: Waiting period before the next attempt according to the retry 
+*							 policy (exponential backoff with jitter).
+*
+* Argument  			Description
+* =========  			===========
+* 1. attempt			Number of the attempt which just failed, starting from 1.
+*
+* Return					Description
+* =========				===========
+* 1. period				Waiting period in ms.
+*
+*******************************************************************************/
+unsigned long	WISMO228::retryPeriod(unsigned char attempt)
+{
+	unsigned	long	period;
+	unsigned	long	limit;
+	
+	period = retryPolicy.baseDelay;
+	
+	// Backoff never exceeds the deadline of the policy, or the default deadline 
+	// if the policy has none
+	if (retryPolicy.deadline > 0)
+	{
+		limit = retryPolicy.deadline;
+	}
+	else
+	{
+		limit = RETRY_DEADLINE;
+	}
+	
+	// Exponential backoff, stop growing once the limit is reached
+	while ((--attempt > 0) && (period < limit))
+	{
+		period *= retryPolicy.factor;
+	}
+	
+	if (period > limit)
+	{
+		period = limit;
+	}
+	
+	if (retryPolicy.jitter > 0)
+	{
+		period += random(retryPolicy.jitter + 1);
+	}
+	
+	return (period);
+}
+
+/*******************************************************************************
+* Name: findReply
+* Description: Wait for a response using the learned timeout of a class of 
+*							 commands and learn from the time it took.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Class of command (refer to getTimeout).
+*
+*	2. response			Expected response.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the response is received or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::findReply(timeoutClass_t type, char *response)
+{
+	bool	success = false;
+	unsigned	long	start;
+	
+	uart->setTimeout(getTimeout(type));
+	
+	start = millis();
+	
+	if (uart->find(response))
+	{
+		learnLatency(type, millis() - start);
+		success = true;
+	}
+	else
+	{
+		// Late or missing response counts as taking the longest allowed time
+		learnLatency(type, latency[type].ceiling);
+	}
+	
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: learnLatency
+* Description: Update smoothed average (weight 1/8) and smoothed deviation 
+*							 (weight 1/4) of the response time of a class of commands.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Class of command (refer to getTimeout).
+*
+*	2. elapsed			Observed response time in ms.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::learnLatency(timeoutClass_t type, unsigned long elapsed)
+{
+	latency_t	*entry = &latency[type];
+	long	error;
+	
+	if (elapsed > entry->ceiling)
+	{
+		elapsed = entry->ceiling;
+	}
+	
+	// First observation replaces the initial guess
+	if (!entry->learned)
+	{
+		entry->average = elapsed;
+		entry->deviation = elapsed / 2;
+		entry->learned = true;
+	}
+	else
+	{
+		error = (long)elapsed - entry->average;
+		entry->average += error / 8;
+		
+		if (error < 0)	error = -error;
+		
+		entry->deviation += (error - (long)entry->deviation) / 4;
+	}
+	
+	// Keep a small deviation for a minimum of headroom
+	if (entry->deviation == 0)
+	{
+		entry->deviation = 1;
+	}
+}
+
+/*******************************************************************************
+* Name: resetLatency
+* Description: Initialize the response time estimate of a class of commands.
+*
+* Argument  			Description
+* =========  			===========
+* 1. type					Class of command (refer to getTimeout).
+*
+*	2. initial			Timeout in ms until a response time is observed.
+*
+*	3. ceiling			Maximum timeout in ms.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::resetLatency(timeoutClass_t type, unsigned int initial, 
+															 unsigned int ceiling)
+{
+	latency[type].average = 0;
+	latency[type].deviation = initial / 4;
+	latency[type].ceiling = ceiling;
+	latency[type].learned = false;
+}
+
+#if WISMO228_GPRS
+/*******************************************************************************
+* Name: configureBearer
+* Description: Send the GPRS bearer configuration the module does not have yet
+*							 as a single command line.
+*
+* Argument  			Description
+* =========  			===========
+* 1. - 3.					Refer to openGPRS.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the bearer is configured or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::configureBearer(const char *apn, const char *username, 
+																const char *password)
+{
+	bool	success = false;
+	unsigned	int	hash;
+	
+	hash = hashString(apn);
+	hash = (hash * 33) ^ hashString(username);
+	hash = (hash * 33) ^ hashString(password);
+	
+	// Only send configuration the module does not have yet (an earlier 
+	// attempt might have failed to start the bearer)
+	if (!(configShadow & CONFIG_STACK))
+	{
+		// Start TCP/IP stack
+		queueCommand(F("+WIPCFG=1"), NULL);
+	}
+	
+	if (!(configShadow & CONFIG_BEARER))
+	{
+		// Open GPRS bearer
+		queueCommand(F("+WIPBR=1,6"), NULL);
+	}
+	
+	if ((linkInterval > 0) && !(configShadow & CONFIG_CREG))
+	{
+		// Report registration changes to the link supervisor
+		queueCommand(F("+CREG=1"), NULL);
+	}
+	
+	if (!(configShadow & CONFIG_APN) || (bearerHash != hash))
+	{
+		// Set the APN, username & password
+		queueCommand(F("+WIPBR=2,6,11,"), apn);
+		queueCommand(F("+WIPBR=2,6,0,"), username);
+		queueCommand(F("+WIPBR=2,6,1,"), password);
+	}
+	
+	if ((commandCount == 0) || sendQueue(true))
+	{
+		configShadow |= CONFIG_STACK | CONFIG_BEARER | CONFIG_APN;
+		
+		if (linkInterval > 0)
+		{
+			configShadow |= CONFIG_CREG;
+		}
+		
+		bearerHash = hash;
+		success = true;
+	}
+	else
+	{
+		// Unknown which of the commands took effect
+		configShadow &= ~(CONFIG_STACK | CONFIG_BEARER | CONFIG_APN);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: startBearer
+* Description: Start the configured GPRS bearer.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the GPRS connection is up or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::startBearer()
+{
+	bool	success = false;
+	
+	// Start GPRS bearer
+	uart->println(F("AT+WIPBR=4,6,0"));
+	
+	readFlash(ok, responseBuffer);
+	
+	// It takes slightly longer to start GPRS bearer 	
+	if (findReply(TIMEOUT_NETWORK, responseBuffer))
+	{
+		// GPRS connection is up
+		status = GPRS_ON;
+		success = true;
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: checkLink
+* Description: Check network registration & GPRS bearer state.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. success			False if the GPRS connection is lost or true if it is up or
+*									the module does not reply.
+*
+*******************************************************************************/
+bool	WISMO228::checkLink()
+{
+	bool	success = true;
+	int	registration;
+	char	terminator[3];
+	
+	registration = readRegistration(TIMEOUT_LOCAL);
+	
+	if (registration >= 0)
+	{
+		// Registered to home network or roaming
+		if ((registration == 1) || (registration == 5))
+		{
+			uart->println(F("AT+WIPBR?"));
+			
+			// Bearer 6 (GPRS) is listed as started before the final "OK"
+			readFlash(bearerUp, responseBuffer);
+			readFlash(ok, terminator);
+			
+			if (uart->findUntil(responseBuffer, terminator))
+			{
+				// Skip the rest of the list
+				uart->find(terminator);
+			}
+			else
+			{
+				success = false;
+			}
+		}
+		else
+		{
+			success = false;
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: stopRegistrationReport
+* Description: Revert the unsolicited registration changes enabled for the link 
+*							 supervisor, which would otherwise keep arriving between 
+*							 replies.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::stopRegistrationReport()
+{
+	if (configShadow & CONFIG_CREG)
+	{
+		uart->println(F("AT+CREG=0"));
+		
+		readFlash(ok, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			configShadow &= ~CONFIG_CREG;
+		}
+	}
+}
+
+/*******************************************************************************
+* Name: superviseLink
+* Description: Check a GPRS connection or make an attempt to restore a lost 
+*							 one. Failed attempts are spaced according to the retry policy 
+*							 and stop after its maximum attempts until the module reports 
+*							 a registration or openGPRS is called.
+*
+* Argument  			Description
+* =========  			===========
+* 1. NIL
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::superviseLink()
+{
+	// Revert to minimum response time	
+	uart->setTimeout(MIN_TIMEOUT);
+	
+	if (status == GPRS_ON)
+	{
+		if (checkLink())
+		{
+			linkPeriod = linkInterval;
+		}
+		else
+		{
+			// Connection lost, restore it right away
+			status = ON;
+			linkDrops++;
+			linkAttempts = 0;
+			// Sockets went down with the connection
+			socketsOpen = 0;
+		}
+	}
+	
+	if (status == ON)
+	{
+		if (linkAttempts < retryPolicy.attempts)
+		{
+			linkAttempts++;
+			
+			// Bearer configuration is normally intact, only the start is sent
+			if (configureBearer(linkApn, linkUsername, linkPassword) && 
+					startBearer())
+			{
+				linkAttempts = 0;
+				linkPeriod = linkInterval;
+			}
+			else
+			{
+				linkPeriod = retryPeriod(linkAttempts);
+			}
+		}
+		else
+		{
+			// Attempts exhausted, wait for a registration change
+			linkPeriod = linkInterval;
+		}
+	}
+}
+
+/*******************************************************************************
+* Name: openPort
+* Description: Open a TCP client socket with a server. Fails right away if the 
+*							 socket is held by a session or the UART carries the data of a
+*							 transparent SMTP session.
+*
+* Argument  			Description
+* =========  			===========
+* 1. index				Socket index.
+*
+*	2. server				Server name or IP.				
+*
+*	3. port					Port number in string format.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if port is successfully open on the server or false if
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::openPort(unsigned char index, const char *server, 
+											 const char *port)
+{
+	bool	success = false;
+	bool	busy;
+	unsigned	char	attempt;
+	unsigned	long	start;
+	dnsEntry_t	*entry;
+	
+	busy = (socketsOpen & (1 << index)) != 0;
+#if WISMO228_EMAIL
+	busy = busy || ((emailSender != NULL) && (dataMode != DATA_BLOCK));
+#endif
+	
+	if (!busy)
+	{
+		// Address resolved on an earlier connection saves a DNS lookup
+		entry = findDns(server);
+		
+		start = millis();
+		
+		// Retry opening a port with remote server according to retry policy
+		for (attempt = 1; ; )
+		{
+			// Create a TCP client socket with server with desired port number
+			uart->print(F("AT+WIPCREATE=2,"));
+			uart->print(index);
+			uart->print(F(",\""));
+			uart->print((entry != NULL) ? entry->address : server);
+			uart->print(F("\","));
+			uart->println(port);
+			
+			// Expecting port open OK response	
+			readFlash(portOk, responseBuffer);	
+			
+			// It takes more time for server to response to port open request	
+			if (findReply(TIMEOUT_SOCKET, responseBuffer) && 
+					(uart->parseInt() == index))
+			{
+				// Port is open
+				success = true;
+				break;
+			}
+			
+			// Cached address might be stale, try the server name right away 
+			// without taking an attempt of the retry policy
+			if (entry != NULL)
+			{
+				entry->address[0] = '\0';
+				entry = NULL;
+			}
+			else if (!retryWait(attempt++, start))	break;
+		}
+		
+		if (success && (entry == NULL))
+		{
+			storeDns(index, server);
+		}
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: findDns
+* Description: Look up the address of a server resolved on an earlier 
+*							 connection.
+*
+* Argument  			Description
+* =========  			===========
+* 1. server				Server name or IP.
+*
+* Return					Description
+* =========				===========
+* 1. entry				Cache entry of the server or NULL if the server is not cached
+*									or the cached address has expired.
+*
+*******************************************************************************/
+dnsEntry_t	*WISMO228::findDns(const char *server)
+{
+	dnsEntry_t	*entry = NULL;
+	unsigned	char	index;
+	unsigned	int	hash;
+	
+	hash = hashString(server);
+	
+	for (index = 0; index < DNS_CACHE_SIZE; index++)
+	{
+		// Hash covers the whole name, the stored name rules out a collision
+		if ((dnsCache[index].address[0] != '\0') && 
+				(dnsCache[index].hash == hash) && 
+				(strncmp(dnsCache[index].server, server, DNS_NAME_MAX) == 0))
+		{
+			if ((millis() - dnsCache[index].timestamp) < DNS_CACHE_TTL)
+			{
+				entry = &dnsCache[index];
+			}
+			else
+			{
+				// Expired
+				dnsCache[index].address[0] = '\0';
+			}
+			break;
+		}
+	}
+	
+	return (entry);
+}
+
+/*******************************************************************************
+* Name: storeDns
+* Description: Cache the peer address of the open TCP socket as the address of 
+*							 the server. Replaces the oldest entry when the cache is full. 
+*							 Names longer than DNS_NAME_MAX are stored truncated.
+*
+* Argument  			Description
+* =========  			===========
+* 1. index				Socket index.
+*
+*	2. server				Server name or IP.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::storeDns(unsigned char index, const char *server)
+{
+	dnsEntry_t	*entry;
+	unsigned	char	slot;
+	unsigned	char	count;
+	const char	*serverPtr;
+	
+	// Server is already an IP address
+	for (serverPtr = server; (*serverPtr == '.') || 
+			 ((*serverPtr >= '0') && (*serverPtr <= '9')); serverPtr++);
+	
+	if (*serverPtr != '\0')
+	{
+		entry = &dnsCache[0];
+		
+		// Empty or oldest entry
+		for (slot = 1; slot < DNS_CACHE_SIZE; slot++)
+		{
+			if ((entry->address[0] != '\0') && 
+					((dnsCache[slot].address[0] == '\0') || 
+					 ((long)(dnsCache[slot].timestamp - entry->timestamp) < 0)))
+			{
+				entry = &dnsCache[slot];
+			}
+		}
+		
+		entry->address[0] = '\0';
+		
+		// Read the peer address of the TCP socket
+		uart->print(F("AT+WIPOPT=2,"));
+		uart->print(index);
+		uart->println(F(",1,2"));
+		
+		readFlash(peerAddress, responseBuffer);
+		
+		if (uart->find(responseBuffer))
+		{
+			count = uart->readBytesUntil('"', entry->address, IP_LENGTH_MAX);
+			entry->address[count] = '\0';
+			
+			readFlash(ok, responseBuffer);
+			
+			if (uart->find(responseBuffer))
+			{
+				entry->hash = hashString(server);
+				strncpy(entry->server, server, DNS_NAME_MAX);
+				entry->server[DNS_NAME_MAX] = '\0';
+				entry->timestamp = millis();
+			}
+			else
+			{
+				entry->address[0] = '\0';
+			}
+		}
+	}
+}
+#endif
+
+/*******************************************************************************
+* Name: hashString
+* Description: Compute a 16-bit hash (djb2) of a string.
+*
+* Argument  			Description
+* =========  			===========
+* 1. string				String to be hashed.
+*
+* Return					Description
+* =========				===========
+* 1. hash					Hash value of the string.
+*
+*******************************************************************************/
+unsigned int	WISMO228::hashString(const char *string)
+{
+	unsigned int	hash = 5381;
+	
+	while (*string != '\0')
+	{
+		hash = (hash << 5) + hash + (unsigned char)*string++;
+	}
+	
+	return (hash);
+}
+
+#if WISMO228_GPRS
+/*******************************************************************************
+* Name: exchangeData
+* Description: Initiate exchange of data process.
+*
+* Argument  			Description
+* =========  			===========
+* 1. index				Socket index.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if data exchange procecss is successfully started or 
+*									false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::exchangeData(unsigned char index)
+{
+	bool	success = false;
+
+	// Expecting data exchanging connection OK response
+	readFlash(connectOk, responseBuffer);	
+	// Initiate data exchange
+	uart->print(F("AT+WIPDATA=2,"));
+	uart->print(index);
+	uart->println(F(",1"));
+		
+	// If data exchanging is ready
+	if (findReply(TIMEOUT_SOCKET, responseBuffer))
+	{
+		success = true;
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: closePort
+* Description: Close a socket.
+*
+* Argument  			Description
+* =========  			===========
+* 1. protocol			Socket protocol (WIP_UDP, WIP_TCP_CLIENT, etc.).
+*
+*	2. index				Socket index.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if port is successfully closed or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::closePort(unsigned char protocol, unsigned char index)
+{
+	bool	success = false;
+	
+	uart->print(F("AT+WIPCLOSE="));
+	uart->print(protocol);
+	uart->print(',');
+	uart->println(index);
+	
+	// Socket is released by the session holding it even if the module does not
+	// reply, it is gone along with the connection
+	if (protocol == WIP_TCP_CLIENT)
+	{
+		socketsOpen &= ~(1 << index);
+	}
+	
+	// Expecting an "OK" response
+	readFlash(ok, responseBuffer);
+	
+	if (uart->find(responseBuffer))
+	{
+		success = true;
+	}
+	
+	return (success);
+}
+#endif
+
+/*******************************************************************************
+* Name: readLine
+* Description: Retrieve a line of response from the WISMO228 module without 
+*							 the line ending. Longer lines are truncated.
+*
+* Argument  			Description
+* =========  			===========
+* 1. line					Location to store the line.
+*
+*	2. limit				Size of the line storage including the string terminator.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if a non empty line is retrieved or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::readLine(char *line, unsigned char limit)
+{
+	unsigned char	count;
+	
+	count = uart->readBytesUntil('\n', line, limit - 1);
+	
+	// Line is too long, discard the rest of it
+	if (count == (limit - 1))
+	{
+		readFlash(lineFeed, responseBuffer);
+		uart->find(responseBuffer);
+	}
+	
+	// Remove carriage return
+	if ((count > 0) && (line[count - 1] == '\r'))
+	{
+		count--;
+	}
+	
+	// Terminate the line string
+	line[count] = '\0';
+	
+	return (count > 0);
+}
+
+/*******************************************************************************
+* Name: lineStartsWith
+* Description: Check the start of a line against a string in flash memory.
+*
+* Argument  			Description
+* =========  			===========
+* 1. line					Line retrieved through readLine.
+*
+*	2. prefix				String of characters stored in flash memory.
+*
+* Return					Description
+* =========				===========
+* 1. match				True if the line starts with the string or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::lineStartsWith(const char *line, char *prefix)
+{
+	readFlash(prefix, responseBuffer);
+	
+	return (strncmp(line, responseBuffer, strlen(responseBuffer)) == 0);
+}
+
+#if WISMO228_EMAIL
+/*******************************************************************************
+* Name: smtpReply
+* Description: Retrieve a (multiline) SMTP server reply and check it's reply 
+*							 code. PIPELINING extension is recorded when advertised.
+*
+* Argument  			Description
+* =========  			===========
+* 1. code					Expected reply code followed by a space stored in flash 
+*									memory.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the reply carries the expected code or false if 
+*									otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::smtpReply(char *code)
+{
+	bool	success = false;
+	bool	waiting;
+	char	line[LINE_LENGTH_MAX];
+	unsigned	long	start;
+	
+	// Reply already received while pipelining says nothing about latency
+	waiting = (uart->available() == 0) && (smtpStart == smtpBuffered);
+	
+	uart->setTimeout(getTimeout(TIMEOUT_SERVER));
+	
+	start = millis();
+	
+	while (smtpReadLine(line, LINE_LENGTH_MAX))
+	{
+		if (waiting)
+		{
+			learnLatency(TIMEOUT_SERVER, millis() - start);
+			waiting = false;
+		}
+		
+		// Every reply line starts with a 3 digit reply code and a separator
+		if (strlen(line) > 3)
+		{
+			if (lineStartsWith(line + 4, smtpPipeliningKeyword))
+			{
+				smtpPipelining = true;
+			}
+			
+			// Reply lines other than the last have a "-" after the reply code
+			if (line[3] != '-')
+			{
+				success = lineStartsWith(line, code);
+				break;
+			}
+		}
+	}
+	
+	if (waiting)
+	{
+		// No reply at all
+		learnLatency(TIMEOUT_SERVER, latency[TIMEOUT_SERVER].ceiling);
+	}
+	
+	// Server replies are retrieved with maximum response time
+	uart->setTimeout(MAX_TIMEOUT);
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: smtpReadLine
+* Description: Retrieve a line of a SMTP server reply. In block mode the reply 
+*							 is retrieved in blocks and the rest of a block is kept for the 
+*							 next line.
+*
+* Argument  			Description
+* =========  			===========
+* 1. - 2.					Refer to readLine.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if a non-empty line is retrieved or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::smtpReadLine(char *line, unsigned char limit)
+{
+	bool	success;
+	unsigned char	count = 0;
+	unsigned long	timeout;
+	char	data = 0;
+	
+	if (dataMode == DATA_BLOCK)
+	{
+		timeout = millis() + getTimeout(TIMEOUT_SERVER);
+		
+		while (data != '\n')
+		{
+			if (smtpStart == smtpBuffered)
+			{
+				smtpStart = 0;
+				smtpBuffered = readBlock(WIP_TCP_CLIENT, SMTP_SOCKET_INDEX, smtpBuffer, 
+																 SMTP_BUFFER_MAX);
+				
+				if (smtpBuffered == 0)
+				{
+					if (timeout <= millis())
+					{
+						break;
+					}
+					continue;
+				}
+			}
+			
+			data = smtpBuffer[smtpStart++];
+			
+			// Line is too long, discard the rest of it
+			if ((data != '\n') && (count < (limit - 1)))
+			{
+				line[count++] = data;
+			}
+		}
+		
+		// Remove carriage return
+		if ((count > 0) && (line[count - 1] == '\r'))
+		{
+			count--;
+		}
+		
+		// Terminate the line string
+		line[count] = '\0';
+		
+		success = (count > 0);
+	}
+	else
+	{
+		success = readLine(line, limit);
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: smtpCommand
+* Description: Send a SMTP command line to the server. In block mode the line is 
+*							 sent as a block.
+*
+* Argument  			Description
+* =========  			===========
+* 1. command			Command stored in flash memory or NULL.
+*
+*	2. argument			Argument following the command or NULL.
+*
+*	3. suffix				Characters stored in flash memory following the argument or 
+*									NULL.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the line is sent or false if otherwise.
+*
+*******************************************************************************/
+bool	WISMO228::smtpCommand(const __FlashStringHelper *command, 
+														const char *argument, 
+														const __FlashStringHelper *suffix)
+{
+	bool	success = false;
+	LengthCounter	counter;
+	
+	if (beginSegment(SMTP_SOCKET_INDEX, 
+									 smtpPrint(&counter, command, argument, suffix)))
+	{
+		smtpPrint(uart, command, argument, suffix);
+		success = endSegment();
+	}
+	
+	return (success);
+}
+
+/*******************************************************************************
+* Name: smtpPrint
+* Description: Print a SMTP command line.
+*
+* Argument  			Description
+* =========  			===========
+* 1. out					Destination of the line (UART or length counter).
+*
+* 2. - 4.					Refer to smtpCommand.
+*
+* Return					Description
+* =========				===========
+* 1. length				Number of characters in the line.
+*
+*******************************************************************************/
+size_t	WISMO228::smtpPrint(Print *out, const __FlashStringHelper *command, 
+														const char *argument, 
+														const __FlashStringHelper *suffix)
+{
+	size_t	size = 0;
+	
+	if (command != NULL)
+	{
+		size += out->print(command);
+	}
+	
+	if (argument != NULL)
+	{
+		size += out->print(argument);
+	}
+	
+	if (suffix != NULL)
+	{
+		size += out->print(suffix);
 	}
 	
-	return (success);
-}	
+	size += out->println();
+	
+	return (size);
+}
 
 /*******************************************************************************
-* Name: setClock
-* Description: Set the WISMO228 module clock.
+* Name: smtpMessage
+* Description: Print the header & message of an email up to the attachment.
 *
 * Argument  			Description
 * =========  			===========
-* 1. clock     		Clock in YY/MM/DD,HH:MM:SS*ZZ format
-*									ZZ represent time difference between local & GMT time 
-*									expressed in quarters of an hour. *ZZ has a range of 
-*									-48 to +48. 
-*									Example: 11/11/16,00:56:24+32 (GMT+8 local time).
-*	
+* 1. out					Destination of the email (UART or length counter).
+*
+* 2. - 5.					Refer to sendEmail.
+*
+*	6. attachmentName	File name of the attachment or NULL without attachment.
+*
 * Return					Description
 * =========				===========
-* 1. success 			True if clock is set successfully or false if otherwise. 
+* 1. length				Number of characters printed.
 *
 *******************************************************************************/
-bool WISMO228::setClock(const char *clock)
+size_t	WISMO228::smtpMessage(Print *out, const char * const *recipients, 
+															unsigned char recipientCount, const char *title, 
+															const char *content, const char *attachmentName)
 {
-	bool success = false;
+	unsigned char	index;
+	size_t	size = 0;
 	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
-	
-	if (status == ON)
+	// Email header
+	size += out->print(F("From: "));
+	size += out->println(emailSender);
+	size += out->print(F("To: "));
+	for (index = 0; index < recipientCount; index++)
 	{
-		// Check for correct clock string length
-		if (strlen(clock) == CLOCK_COUNT_MAX)
+		if (index > 0)
 		{
-			uart->print(F("AT+CCLK=\""));
-			uart->print(clock);
-			uart->print(F("\"\r\n"));
-			
-			// Expecting an "OK" response
-			readFlash(ok, responseBuffer);
-			
-			if (uart->find(responseBuffer))
-			{
-				success = true;
-			}
+			size += out->print(F(", "));
 		}
+		size += out->print(recipients[index]);
 	}
+	size += out->println();
+	size += out->print(F("Subject: "));
+	size += out->println(title);
 	
-	return (success);
-}	
+	if (attachmentName != NULL)
+	{
+		// Message & attachment as separate parts
+		size += out->println(F("MIME-Version: 1.0"));
+		size += out->print(F("Content-Type: multipart/mixed; boundary=\""));
+		size += out->print(F(MIME_BOUNDARY));
+		size += out->print(F("\"\r\n\r\n--"));
+		size += out->println(F(MIME_BOUNDARY));
+		size += out->println(F("Content-Type: text/plain"));
+	}
+	
+	size += out->print(F("\r\n"));
+	// Email message
+	size += out->print(content);
+	
+	if (attachmentName != NULL)
+	{
+		size += out->print(F("\r\n--"));
+		size += out->println(F(MIME_BOUNDARY));
+		size += out->print(F("Content-Type: application/octet-stream; name=\""));
+		size += out->print(attachmentName);
+		size += out->println(F("\""));
+		size += out->println(F("Content-Transfer-Encoding: base64"));
+		size += out->print(F("Content-Disposition: attachment; filename=\""));
+		size += out->print(attachmentName);
+		size += out->print(F("\"\r\n\r\n"));
+	}
+	
+	return (size);
+}
+#endif
 
+#if WISMO228_PING
 /*******************************************************************************
-* Name: getRssi
-* Description: Retrieve the WISMO228 module RSSI value in dBm.
+* Name: pingReceived
+* Description: Update ping series statistics with a ping reply.
 *
 * Argument  			Description
 * =========  			===========
-* 1. NIL
-*	
+* 1. line					Ping reply following "+WIPPING: ".
+*
 * Return					Description
 * =========				===========
-* 1. rssi 				RSSI value in dBm. 
+* 1. NIL
 *
 *******************************************************************************/
-int	WISMO228::getRssi()
+void	WISMO228::pingReceived(const char *line)
 {
-	int rssi;
-	char	rxByte;
+	unsigned	int	timeout;
+	unsigned	int	index;
+	unsigned	int	responseTime;
 	
-	rssi = 0;
-	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
-	
-	if (status == ON)
+	if (sscanf(line, "%u,%u,%u", &timeout, &index, &responseTime) == 3)
 	{
-		uart->println(F("AT+CSQ"));
-		
-		readFlash(rssiCheck, responseBuffer);
-		
-		if (uart->find(responseBuffer))
+		if (timeout != 0)
 		{
-			while (!uart->available());
+			pingStats.lost++;
+		}
+		else
+		{
+			if ((pingStats.received == 0) || (responseTime < pingStats.minimum))
+			{
+				pingStats.minimum = responseTime;
+			}
 			
-			rxByte = (char)uart->read();
+			if (responseTime > pingStats.maximum)
+			{
+				pingStats.maximum = responseTime;
+			}
 			
-			// Ensure numeric characters is received
-			if ((rxByte >= '0') && (rxByte <= '9'))
+			if (pingStats.received > 0)
 			{
-				// Convert ASCII 0-9 to integer
-				rssi = rxByte - 0x30;
-				
-				while (!uart->available());
-				
-				rxByte = uart->read();
-				
-				if ((rxByte >= '0') && (rxByte <= '9'))
-				{
-					// Convert to tens
-					rssi *= 10;
-					// Add LSB
-					rssi += rxByte - 0x30;
-					
-					// If RSSI value falls within range
-					if ((rssi >= 0) && (rssi <= 31))
-					{
-						// Convert RSSI to dbm
-						rssi = rssiToDbm(rssi);
-					}
-					
-					while (!uart->available());
-					
-					rxByte = uart->read();
-					
-					if (rxByte == ',')
-					{
-						while (!uart->available());
-						
-						rxByte = uart->read();
-						
-						// Expecting an "OK" response
-						readFlash(ok, responseBuffer);
-						
-						switch (rxByte)
-						{
-							case '0':
-							case '1':
-							case '2':
-							case '3':
-							case '4':
-							case '5':
-							case '6':
-							case '7':
-								// Check ending sequence
-								if (!uart->find(responseBuffer))
-								{
-									rssi = 0;
-								}
-								break;
-								
-							case '9':
-								while (!uart->available());
-								rxByte = uart->read();
-								// BER: 99
-								if (rxByte == '9')
-								{
-									// Check ending sequence
-									if (!uart->find(responseBuffer))
-									{
-										rssi = 0;
-									}
-								}
-								break;
-								
-							default:
-								rssi = 0;
-								break;
-						}
-					}	
-				}
-				else if (rxByte == ',')
-				{
-					rssi = rssiToDbm(rssi);
-				}
+				pingJitterSum += (responseTime > pingLast) ? 
+												 (responseTime - pingLast) : (pingLast - responseTime);
+				pingStats.jitter = pingJitterSum / pingStats.received;
 			}
+			
+			pingLast = responseTime;
+			pingSum += responseTime;
+			pingStats.received++;
+			pingStats.average = pingSum / pingStats.received;
 		}
 	}
-
-	return (rssi);
 }
+#endif
 
+#if WISMO228_GPRS
 /*******************************************************************************
-* Name: rssiToDbm
-* Description: Convert RSSI value into dBm.
+* Name: beginBlock
+* Description: Request to send a block of data of known length through a socket.
+*							 Caller writes exactly the requested number of bytes to the 
+*							 UART and completes the block with endBlock.
 *
 * Argument  			Description
 * =========  			===========
-* 1. rssi					RSSI value in decimal 0-31.		
-*	
+* 1. protocol			Socket protocol (WIP_UDP, WIP_TCP_CLIENT, etc.).
+*
+*	2. index				Socket index.
+*
+*	3. length				Number of bytes in the block.
+*
 * Return					Description
 * =========				===========
-* 1. rssi 				RSSI value in dBm. 
+* 1. success			True if module is ready to accept the block or false if 
+*									otherwise.
 *
 *******************************************************************************/
-int	WISMO228::rssiToDbm(int	rssi)
+bool	WISMO228::beginBlock(unsigned char protocol, unsigned char index, 
+													 unsigned int length)
 {
-	rssi = (rssi*2) + MINIMUM_SIGNAL_DBM;
-
-	return (rssi);				
+	bool	success = false;
+	
+	uart->print((const __FlashStringHelper *)blockCommand);
+	uart->print(protocol);
+	uart->print(',');
+	uart->print(index);
+	uart->print(F(",1,"));
+	uart->println(length);
+	
+	// Expecting data input prompt
+	readFlash(writeCursor, responseBuffer);
+	
+	if (uart->find(responseBuffer))
+	{
+		success = true;
+	}
+	
+	return (success);
 }
 
 /*******************************************************************************
-* Name: waitForReply
-* Description: Wait for certain number of charaters from WISMO228 module within 
-*							 a certain time frame.
+* Name: endBlock
+* Description: Wait for the module to acknowledge a block of data.
 *
 * Argument  			Description
 * =========  			===========
-* 1. count				Number of expected characters from WISMO228 module.				
-*
-*	2. period				Time frame to wait for the reply from WISMO228 module in ms.
+* 1. NIL
 *
 * Return					Description
 * =========				===========
-* 1. success			True if the expected number of characters from the WISMO228 
-*									module is received within the stipulated time frame or false 
-*									if otherwise.
+* 1. success			True if the block is accepted or false if otherwise.
 *
 *******************************************************************************/
-bool	WISMO228::waitForReply(unsigned char count, long period)
+bool	WISMO228::endBlock()
 {
 	bool	success = false;
-	unsigned long	timeout;
-	
-	timeout = millis() + period;
 	
-	while ((uart->available() < count) && (timeout > millis()));
+	// Expecting an "OK" response
+	readFlash(ok, responseBuffer);
 	
-	if ((uart->available() >= count) && (timeout > millis()))
+	if (uart->find(responseBuffer))
 	{
 		success = true;
 	}
@@ -1621,93 +7115,114 @@ bool	WISMO228::waitForReply(unsigned char count, long period)
 }
 
 /*******************************************************************************
-* Name: openPort
-* Description: Open a port on a server.
+* Name: readBlock
+* Description: Retrieve pending data of a socket in block mode.
 *
 * Argument  			Description
 * =========  			===========
-* 1. server				Server name or IP.				
+* 1. protocol			Socket protocol (WIP_UDP, WIP_TCP_CLIENT, etc.).
+*
+*	2. index				Socket index.
+*
+*	3. data					Location to store the retrieved data.
 *
-*	2. port					Port number in string format.
+*	4. limit				The maximum number of bytes to retrieve.
 *
 * Return					Description
 * =========				===========
-* 1. success			True if port is successfully open on the server or false if
-*									otherwise.
+* 1. count				Number of bytes retrieved.
 *
 *******************************************************************************/
-bool	WISMO228::openPort(const char	*server, const char *port)
+unsigned int	WISMO228::readBlock(unsigned char protocol, unsigned char index, 
+																	char *data, unsigned int limit)
 {
-	bool	success = false;
-	unsigned	char	attempt;
+	unsigned int	count = 0;
 	
-	// It takes more time for server to response to port open request	
-	uart->setTimeout(MED_TIMEOUT);
+	uart->print((const __FlashStringHelper *)blockCommand);
+	uart->print(protocol);
+	uart->print(',');
+	uart->print(index);
+	uart->print(F(",0,"));
+	uart->println(limit);
 	
-	// Expecting port open OK response	
-	readFlash(portOk, responseBuffer);	
+	readFlash(blockRead, responseBuffer);
 	
-	// Maximum 3 attempt to open a port with remote server
-	for (attempt = 3; attempt > 0; attempt--)
+	if (uart->find(responseBuffer))
 	{
-		// Create a TCP client socket with server with desired port number
-		uart->print(F("AT+WIPCREATE=2,1,\""));
-		uart->print(server);
-		uart->print(F("\","));
-		uart->println(port);
+		// Skip the protocol and socket index
+		uart->parseInt();
+		uart->parseInt();
+		count = uart->parseInt();
+		
+		// Module should never return more than requested
+		if (count > limit)
+		{
+			count = limit;
+		}
+		
+		readFlash(newLine, responseBuffer);
 		
 		if (uart->find(responseBuffer))
 		{
-			// Port is open
-			success = true;
-			break;
+			// Data might contain any byte value, read by count
+			count = uart->readBytes(data, count);
+			
+			// Expecting an "OK" response
+			readFlash(ok, responseBuffer);
+			
+			if (!uart->find(responseBuffer))
+			{
+				count = 0;
+			}
+		}
+		else
+		{
+			count = 0;
 		}
 	}
 	
-	// Revert back to minimal response time
-	uart->setTimeout(MIN_TIMEOUT);
-	
-	return (success);
+	return (count);
 }
 
 /*******************************************************************************
-* Name: exchangeData
-* Description: Initiate exchange of data process.
+* Name: waitForBlock
+* Description: Wait for data on a socket in block mode and retrieve it. The 
+*							 retrieved data is terminated as a string.
 *
 * Argument  			Description
 * =========  			===========
-* 1. NIL
+* 1. - 4.					Refer to readBlock. Limit excludes the string terminator.
+*
+*	5. period				Time frame to wait for the data in ms.
 *
 * Return					Description
 * =========				===========
-* 1. success			True if data exchange procecss is successfully started or 
-*									false if otherwise.
+* 1. count				Number of bytes retrieved. 0 if no data arrives within the 
+*									stipulated time frame.
 *
 *******************************************************************************/
-bool	WISMO228::exchangeData()
+unsigned int	WISMO228::waitForBlock(unsigned char protocol, unsigned char index, 
+																		 char *data, unsigned int limit, 
+																		 long period)
 {
-	bool	success = false;
-
-	// Revert to medium response time	
-	uart->setTimeout(MED_TIMEOUT);
+	unsigned int	count = 0;
+	unsigned long	timeout;
 	
-	// Expecting data exchanging connection OK response
-	readFlash(connectOk, responseBuffer);	
-	// Initiate data exchange
-	uart->println(F("AT+WIPDATA=2,1,1"));
-		
-	// If data exchanging is ready
-	if (uart->find(responseBuffer))
+	timeout = millis() + period;
+	
+	while ((count == 0) && (timeout > millis()))
 	{
-		success = true;
+		count = readBlock(protocol, index, data, limit);
 	}
 	
-	// Revert to minimum response time	
-	uart->setTimeout(MIN_TIMEOUT);
+	// Terminate the string
+	data[count] = '\0';
 	
-	return (success);
+	return (count);
 }
+#endif
 
+#if WISMO228_EMAIL
 /*******************************************************************************
 * Name: encodeBase64
 * Description: Base 64 encoder.
@@ -1726,75 +7241,145 @@ bool	WISMO228::exchangeData()
 void	WISMO228::encodeBase64(const char *input, char *output)
 {
 	unsigned	int	length;
-	char	raw[3];
-	char	encoded[4];
 	
 	// Get input string length
 	length = strlen(input);
 	
-	// Perform normal encoding for length more than 2 characters			
-	while (length > 2)
+	// Expand 3 characters to 4 characters (8-bit each to 6-bit each)
+	while (length > 0)
 	{
-		// Retrieve 3 bytes at a time
-		raw[0] = *input++;	
-		raw[1] = *input++;
-		raw[2] = *input++;
-		
-		// Reduce 3 characters
-		length -= 3;
+		encodeBase64Group(input, min(length, 3), output);
 		
-		// Expand 3 characters to 4 characters (8-bit each to 6-bit each)
-		encoded[0] = (raw[0] & B11111100) >> 2;
-		encoded[1] = ((raw[0] & B00000011) << 4) | ((raw[1] & B11110000) >> 4);
-		encoded[2] = ((raw[1] & B00001111) << 2) | ((raw[2] & B11000000) >> 6);
-		encoded[3] = (raw[2] & B00111111);
-		
-		// Retrieve corresponding encoded characters
-		*output++ = pgm_read_byte_near(base64Table + encoded[0]);
-		*output++ = pgm_read_byte_near(base64Table + encoded[1]);
-		*output++ = pgm_read_byte_near(base64Table + encoded[2]);
-		*output++ = pgm_read_byte_near(base64Table + encoded[3]);
+		input += min(length, 3);
+		length -= min(length, 3);
+		output += 4;
 	}
 	
-	// Special treatment for remaining 2 characters
-	if (length == 2)
+  // Terminate the output string
+  *output = '\0';
+}
+
+/*******************************************************************************
+* Name: encodeBase64
+* Description: Streaming base 64 encoder. Data is read from a user data source 
+*							 and written to the UART in lines of 76 characters as required 
+*							 by MIME, using a constant amount of RAM.
+*
+* Argument  			Description
+* =========  			===========
+* 1. source				Function filling the data buffer with up to size bytes and 
+*									returning the number of bytes filled. Returns 0 when the end 
+*									of the data is reached.
+*
+* Return					Description
+* =========				===========
+* 1. success			True if the data is encoded up to the end of the source or 
+*									false if sending a line failed and the encoding is aborted.
+*
+*******************************************************************************/
+bool	WISMO228::encodeBase64(unsigned int (*source)(char *data, 
+														unsigned int size))
+{
+	char	raw[BASE64_INPUT_MAX];
+	char	encoded[4];
+	unsigned	int	length;
+	unsigned	int	count;
+	unsigned	int	index;
+	bool	success = true;
+	bool	end = false;
+	
+	while (!end && success)
 	{
-		// Retrieve the last 2 characters and pad with 1 zero character
-		raw[0] = *input++;
-		raw[1] = *input;
-    raw[2] = 0;
+		length = 0;
+		
+		// Source might return less than requested, fill up a complete line
+		while (length < BASE64_INPUT_MAX)
+		{
+			count = source(raw + length, BASE64_INPUT_MAX - length);
+			
+			if (count == 0)
+			{
+				end = true;
+				break;
+			}
+			
+			length += count;
+		}
 		
-		encoded[0] = (raw[0] & B11111100) >> 2;
-		encoded[1] = ((raw[0] & B00000011) << 4) | ((raw[1] & B11110000) >> 4);
-		encoded[2] = ((raw[1] & B00001111) << 2) | ((raw[2] & B11000000) >> 6);	
+		if (length > 0)
+		{
+			// Every line is a segment of 4 characters per 3 bytes & a line break
+			success = false;
+			
+			if (beginSegment(SMTP_SOCKET_INDEX, ((length + 2) / 3) * 4 + 2))
+			{
+				for (index = 0; index < length; index += 3)
+				{
+					encodeBase64Group(raw + index, min(length - index, 3), encoded);
+					uart->write((const uint8_t *)encoded, 4);
+				}
+				
+				uart->print(F("\r\n"));
+				
+				success = endSegment();
+			}
+		}
+	}
+	
+	return (success);
+}
 
-		// Retrieve corresponding encoded characters and '=' for last character
-		*output++ = pgm_read_byte_near(base64Table + encoded[0]);
-		*output++ = pgm_read_byte_near(base64Table + encoded[1]);
-		*output++ = pgm_read_byte_near(base64Table + encoded[2]);
-		*output++ = '=';
+/*******************************************************************************
+* Name: encodeBase64Group
+* Description: Encode a group of up to 3 characters into 4 base 64 characters.
+*							 Missing characters are padded with "=".
+*
+* Argument  			Description
+* =========  			===========
+* 1. raw					Characters to be encoded.
+*
+*	2. length				Number of characters to be encoded (1 to 3).
+*
+*	3. encoded			Location to store the 4 encoded characters.
+*
+* Return					Description
+* =========				===========
+* 1. NIL
+*
+*******************************************************************************/
+void	WISMO228::encodeBase64Group(const char *raw, unsigned char length, 
+																	char *encoded)
+{
+	unsigned	char	byte1;
+	unsigned	char	byte2;
+	unsigned	char	byte3;
+	
+	// Pad missing characters with zero
+	byte1 = raw[0];
+	byte2 = (length > 1) ? raw[1] : 0;
+	byte3 = (length > 2) ? raw[2] : 0;
+	
+	// Retrieve corresponding encoded characters
+	encoded[0] = pgm_read_byte_near(base64Table + ((byte1 & B11111100) >> 2));
+	encoded[1] = pgm_read_byte_near(base64Table + (((byte1 & B00000011) << 4) | 
+																								 ((byte2 & B11110000) >> 4)));
+	encoded[2] = pgm_read_byte_near(base64Table + (((byte2 & B00001111) << 2) | 
+																								 ((byte3 & B11000000) >> 6)));
+	encoded[3] = pgm_read_byte_near(base64Table + (byte3 & B00111111));
+	
+	// '=' for missing characters
+	if (length < 3)
+	{
+		encoded[3] = '=';
 	}
 	
-	// Special treatment for remaining 1 characters
-	if (length == 1)
+	if (length < 2)
 	{
-		// Retrieve the last character and pad with 1 zero character
-		raw[0] = *input;
-    raw[1] = 0;
-		
-		encoded[0] = (raw[0] & B11111100) >> 2;
-		encoded[1] = ((raw[0] & B00000011) << 4) | ((raw[1] & B11110000) >> 4);
-		
-		// Retrieve corresponding encoded characters and '=' for last 2 characters
-		*output++ = pgm_read_byte_near(base64Table + encoded[0]);
-		*output++ = pgm_read_byte_near(base64Table + encoded[1]);
-		*output++ = '=';
-		*output++ = '=';
+		encoded[2] = '=';
 	}
-  // Terminate the output string
-  *output = '\0';
 }
 
+#endif
 
 /*******************************************************************************
 * Name: readFlash
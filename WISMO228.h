@@ -3,6 +3,7 @@
 #include	<avr/pgmspace.h>
 #include	<SoftwareSerial.h>
 #include "Arduino.h"
+#include "WISMO228Config.h"
 
 #define NC	0xFF
 #define	BAUD_RATE	9600
@@ -12,8 +13,68 @@
 #define	MINIMUM_SIGNAL_DBM	-113
 #define	CLOCK_COUNT_MAX 20
 #define	SMS_LENGTH_MAX	160
+#define	SENDER_LENGTH_MAX	20
+#define	WHITELIST_EMPTY	0xFFFFFFFFUL
+#define	WHITELIST_REMOVED	0x00000000UL
 #define	RESPONSE_TIME_MAX	6
 #define	RESPONSE_LENGTH_MAX 30
+#define	WIP_UDP	1
+#define	WIP_TCP_CLIENT	2
+#define	WIP_TCP_SERVER	3
+#define	WIP_FTP	4
+#define	SOCKET_INDEX	1
+#define	SEQUENCE_LENGTH	5
+#define	SERVER_INDEX	1
+#define	SERVER_SOCKET_FIRST	2
+#define	SERVER_SOCKET_LAST	4
+#define	MQTT_SOCKET_INDEX	5
+#define	SMTP_SOCKET_INDEX	6
+#define	LINE_LENGTH_MAX	40
+#define	FTP_CHUNK_MAX	32
+#define	ETX	0x03
+#define	DLE	0x10
+#define	BASE64_INPUT_MAX	57
+#define	MIME_BOUNDARY	"WISMO228-MIME-BOUNDARY"
+#define	SMTP_BUFFER_MAX	32
+#define	IP_LENGTH_MAX	15
+#define	DNS_CACHE_SIZE	2
+#define	DNS_CACHE_TTL	3600000UL
+#define	DNS_NAME_MAX	24
+#define	PING_TIMEOUT	2000
+#define	HTTP_CHUNK_MAX	64
+#define	HTTP_LENGTH_UNKNOWN	0
+#define	MQTT_PACKET_MAX	128
+#define	MQTT_HEADER_MAX	5
+#define	MQTT_CONNECT	0x10
+#define	MQTT_CONNACK	0x20
+#define	MQTT_PUBLISH	0x30
+#define	MQTT_PUBACK	0x40
+#define	MQTT_SUBSCRIBE	0x82
+#define	MQTT_SUBACK	0x90
+#define	MQTT_PINGREQ	0xC0
+#define	MQTT_PINGRESP	0xD0
+#define	MQTT_DISCONNECT	0xE0
+#define	SIGNAL_SCALE	16
+#define	TIMEOUT_FLOOR	500
+#define	TIMEOUT_CLASSES	4
+#define	RETRY_ATTEMPTS	3
+#define	RETRY_DELAY	1000
+#define	RETRY_FACTOR	2
+#define	RETRY_JITTER	500
+#define	RETRY_DEADLINE	30000UL
+#define	TIME_DRIFT_PERIOD	600
+#define	TIME_DRIFT_MAX	10000
+#define	TIME_STEP_MAX	60
+#define	COMMAND_QUEUE_MAX	6
+#define	CONFIG_STORE_NONE	0xFFFF
+#define	CONFIG_SIGNATURE	0x5A00
+#define	CONFIG_ECHO_OFF	0x01
+#define	CONFIG_SMS	0x02
+#define	CONFIG_RING	0x04
+#define	CONFIG_STACK	0x08
+#define	CONFIG_BEARER	0x10
+#define	CONFIG_APN	0x20
+#define	CONFIG_CREG	0x40
 
 enum status_t{ 
 	OFF, 
@@ -22,59 +83,342 @@ enum status_t{
 	ERROR
 };
 
+struct dnsEntry_t{
+	unsigned	int	hash;
+	char	server[DNS_NAME_MAX + 1];
+	char	address[IP_LENGTH_MAX + 1];
+	unsigned	long	timestamp;
+};
+
+struct pingStats_t{
+	unsigned	char	sent;
+	unsigned	char	received;
+	unsigned	char	lost;
+	unsigned	int	minimum;
+	unsigned	int	average;
+	unsigned	int	maximum;
+	unsigned	int	jitter;
+};
+
+enum timeoutClass_t{
+	TIMEOUT_LOCAL,
+	TIMEOUT_NETWORK,
+	TIMEOUT_SOCKET,
+	TIMEOUT_SERVER
+};
+
+struct latency_t{
+	unsigned	int	average;
+	unsigned	int	deviation;
+	unsigned	int	ceiling;
+	bool	learned;
+};
+
+struct atCommand_t{
+	const	__FlashStringHelper	*command;
+	const	char	*argument;
+};
+
+typedef	void	(*smsHandler_t)(const char *sender, const char *arguments);
+
+struct smsCommand_t{
+	const	char	*keyword;
+	smsHandler_t	handler;
+};
+
+struct retryPolicy_t{
+	unsigned	char	attempts;
+	unsigned	int	baseDelay;
+	unsigned	char	factor;
+	unsigned	int	jitter;
+	unsigned	long	deadline;
+};
+
+enum dataMode_t{
+	DATA_TRANSPARENT,
+	DATA_BLOCK
+};
+
 class WISMO228
 {
 	public:
 	
     WISMO228(HardwareSerial *hardwarePort, unsigned char onOffPin);
     WISMO228(SoftwareSerial *softwarePort, unsigned char onOffPin);
+    WISMO228(Stream *port, unsigned char onOffPin);
     WISMO228(HardwareSerial *hardwarePort, unsigned char onOffPin, 
 					   unsigned char ringPin, void (*newSmsFunction)(void));
     WISMO228(SoftwareSerial *softwarePort, unsigned char onOffPin, 
 					   unsigned char ringPin, void (*newSmsFunction)(void));
 			 
 		void	init();
+		void	setConfigStore(unsigned int address);
 		void	shutdown();
 		bool	powerUp();
 		
+#if WISMO228_SMS
 		bool	sendSms(const char *recipient, const char *message);
+		unsigned char	sendSms(const char * const *recipients, 
+													unsigned char recipientCount, const char *message, 
+													bool *results);
+		unsigned int	getSmsRate();
 		bool	readSms(char *sender, char *message);
+		void	setWhitelist(unsigned int address, unsigned char slots);
+		void	clearWhitelist();
+		bool	addSender(const char *sender);
+		bool	removeSender(const char *sender);
+		bool	dispatchSms(const smsCommand_t *table, unsigned char count, 
+											const char *sender, char *message);
+		bool	processSms(const smsCommand_t *table, unsigned char count);
+		bool	getSmsStorage(unsigned char *used, unsigned char *total);
+		bool	selectSmsStorage();
+		void	setSmsCleanup(unsigned char threshold);
+#endif
 		
+#if WISMO228_GPRS
 		bool	openGPRS(const char *apn, const char *username, const char *password);
 		bool	closeGPRS();
+		void	setLinkSupervisor(unsigned long interval);
+		unsigned int	getLinkDrops();
+#endif
 		
+#if WISMO228_HTTP
 		bool	getHttp(const char *server, const char *path, const char *port, 
 									char *message, unsigned int limit);
 		
 		bool	putHttp(const char *server, const char *path, const char *port, 
                   const char *host, const char *data, const char *controlKey, 
 									const char *contentType);					
+		bool	postHttp(const char *server, const char *path, const char *port, 
+									 const char *host, const char *controlKey, 
+									 const char *contentType, unsigned long length, 
+									 unsigned int (*source)(char *data, unsigned int size));
+		bool	putHttp(const char *server, const char *path, const char *port, 
+									const char *host, const char *controlKey, 
+									const char *contentType, unsigned long length, 
+									unsigned int (*source)(char *data, unsigned int size));
+#endif
 		
+#if WISMO228_EMAIL
 		bool	sendEmail(const char *smtpServer, const char	*port, 
 										const char *username, const char *password, 
 									  const char *recipient, const char *title, 
 										const char *content);
+		bool	sendEmail(const char *smtpServer, const char	*port, 
+										const char *username, const char *password, 
+										const char * const *recipients, 
+										unsigned char recipientCount, const char *title, 
+										const char *content);
+		bool	openEmail(const char *smtpServer, const char *port, 
+										const char *username, const char *password);
+		bool	sendEmail(const char *recipient, const char *title, 
+										const char *content);
+		bool	sendEmail(const char * const *recipients, 
+										unsigned char recipientCount, const char *title, 
+										const char *content);
+		bool	sendEmail(const char * const *recipients, 
+										unsigned char recipientCount, const char *title, 
+										const char *content, const char *attachmentName, 
+										unsigned int (*source)(char *data, unsigned int size));
+		bool	closeEmail();
+#endif
 		
+#if WISMO228_CLOCK
 		bool	getClock(char *clock);
 		bool	setClock(const char *clock);
+		bool	syncTime(bool network, unsigned long interval);
+		unsigned long	getTime();
+		int	getTimeZone();
+#endif
 		
+#if WISMO228_PING
 		unsigned int	ping(const char	*url);
+		bool	startPing(const char *url, unsigned char count, unsigned int size, 
+										unsigned int interval);
+		bool	getPingStats(pingStats_t *stats);
+#endif
 		
 		status_t	getStatus();
 		
 		int	getRssi();
+		unsigned int	getTimeout(timeoutClass_t type);
+		void	setRetryPolicy(const retryPolicy_t *policy);
+		void	setIdleCallback(void (*idleFunction)(void));
+		void	cancelRetry();
+		void	setSignalMonitor(unsigned long interval, int threshold);
+		int	getSignalAverage();
+		int	getSignalTrend();
+		unsigned char	getBer();
+		bool	signalAllows(bool urgent);
+		
+#if WISMO228_GPRS
+		void	setDataMode(dataMode_t mode);
+		bool	openSocket(const char *server, const char *port);
+		bool	closeSocket();
+		bool	writeSocket(const char *data, unsigned int length);
+		unsigned int	readSocket(char *data, unsigned int limit);
+#endif
+		
+#if WISMO228_SERVER
+		bool	openServer(const char *port, 
+										 void (*acceptFunction)(unsigned char socket));
+		bool	closeServer();
+#endif
+#if WISMO228_GPRS
+		bool	closeSocket(unsigned char socket);
+		bool	writeSocket(unsigned char socket, const char *data, 
+										  unsigned int length);
+		unsigned int	readSocket(unsigned char socket, char *data, 
+														 unsigned int limit);
+#endif
+		void	poll();
+		
+#if WISMO228_FTP
+		bool	ftpUpload(const char *server, const char *port, 
+										const char *username, const char *password, 
+										const char *filename, 
+										unsigned int (*source)(char *data, unsigned int size));
+		unsigned long	getFtpThroughput();
+#endif
+		
+#if WISMO228_GPRS
+		void	clearDnsCache();
+#endif
+		
+#if WISMO228_UDP
+		bool	openUdp(const char *server, const char *port);
+		bool	closeUdp();
+		bool	sendDatagram(const char *data, unsigned int length, bool acknowledge);
+		unsigned int	readDatagram(char *data, unsigned int limit);
+		unsigned int	getDatagramLoss();
+#endif
+		
+#if WISMO228_MQTT
+		bool	mqttConnect(const char *server, const char *port, 
+											const char *clientId, const char *username, 
+											const char *password, unsigned int keepAlive);
+		bool	mqttPublish(const char *topic, const char *payload, 
+											unsigned char qos);
+		bool	mqttSubscribe(const char *topic, unsigned char qos);
+		bool	mqttPing();
+		bool	mqttLoop();
+		bool	mqttDisconnect();
+		void	setMqttCallback(void (*messageFunction)(const char *topic, 
+																										const char *payload));
+#endif
 	
 	private:
 		bool	simReady();
 		bool	offEcho();
 		bool	registerNetwork();
-		bool	textModeSms();
-		bool	newSmsSetup();
-		bool	openPort(const char	*server, const char *port);
-		bool	exchangeData();
+		int	readRegistration(timeoutClass_t type);
+		bool	smsSetup();
+#if WISMO228_SMS
+		bool	submitSms(const char *recipient, const char *message);
+		void	cleanupSms();
+		int	findSender(const char *sender);
+		uint32_t	senderHash(const char *sender);
+		uint32_t	*whitelistSlot(unsigned char slot);
+		int	compareKeyword(const char *word, const char *keyword);
+#endif
+		unsigned int	storedConfig();
+#if WISMO228_GPRS
+		bool	configureBearer(const char *apn, const char *username, 
+													const char *password);
+		bool	startBearer();
+		bool	checkLink();
+		void	stopRegistrationReport();
+		void	superviseLink();
+		bool	openPort(unsigned char index, const char *server, const char *port);
+		bool	exchangeData(unsigned char index);
+		dnsEntry_t	*findDns(const char *server);
+		void	storeDns(unsigned char index, const char *server);
+#endif
+		unsigned int	hashString(const char *string);
+#if WISMO228_GPRS
+		bool	closePort(unsigned char protocol, unsigned char index);
+#endif
+		bool	readLine(char *line, unsigned char limit);
+		bool	lineStartsWith(const char *line, char *prefix);
+#if WISMO228_EMAIL
+		bool	smtpReply(char *code);
+		bool	smtpReadLine(char *line, unsigned char limit);
+		bool	smtpCommand(const __FlashStringHelper *command, 
+											const char *argument, 
+											const __FlashStringHelper *suffix);
+		size_t	smtpPrint(Print *out, const __FlashStringHelper *command, 
+										const char *argument, const __FlashStringHelper *suffix);
+		size_t	smtpMessage(Print *out, const char * const *recipients, 
+											unsigned char recipientCount, const char *title, 
+											const char *content, const char *attachmentName);
+#endif
+#if WISMO228_PING
+		void	pingReceived(const char *line);
+#endif
+#if WISMO228_GPRS
+		bool	beginBlock(unsigned char protocol, unsigned char index, 
+											 unsigned int length);
+		bool	endBlock();
+		unsigned int	readBlock(unsigned char protocol, unsigned char index, 
+													char *data, unsigned int limit);
+		unsigned int	waitForBlock(unsigned char protocol, unsigned char index, 
+														 char *data, unsigned int limit, long period);
+#endif
+#if WISMO228_MQTT
+		unsigned int	mqttString(unsigned int offset, const char *string);
+		unsigned int	mqttHeader(unsigned char type, unsigned int length);
+		bool	mqttSend(unsigned int length);
+		bool	mqttRead(char *data, unsigned int count, long period);
+		bool	mqttReadPacket(unsigned char *type, unsigned int *length, 
+												 long period);
+		bool	mqttWaitFor(unsigned char type, unsigned int packetId, 
+										unsigned int minimum);
+		void	mqttReceived(unsigned char type, unsigned int length);
+#endif
+#if WISMO228_HTTP
+		size_t	getRequest(Print *out, const char *server, const char *path);
+		size_t	putRequest(Print *out, const char *path, const char *host, 
+											 const char *data, const char *controlKey, 
+											 const char *contentType);
+		size_t	printTemplate(Print *out, const char *format, 
+												const char * const *fields);
+		bool	streamHttp(bool post, const char *server, const char *path, 
+										 const char *port, const char *host, 
+										 const char *controlKey, const char *contentType, 
+										 unsigned long length, 
+										 unsigned int (*source)(char *data, unsigned int size));
+		size_t	streamRequest(Print *out, bool post, const char *path, 
+												const char *host, const char *controlKey, 
+												const char *contentType, unsigned long length);
+#endif
+#if WISMO228_HTTP || WISMO228_EMAIL
+		bool	beginSegment(unsigned char index, unsigned int length);
+		bool	endSegment();
+#endif
 		bool	waitForReply(unsigned char count, long period);
+		void	queueCommand(const __FlashStringHelper *command, 
+												 const char *argument);
+		bool	sendQueue(bool joined);
+		bool	retryWait(unsigned char attempt, unsigned long start);
+		unsigned long	retryPeriod(unsigned char attempt);
+		bool	findReply(timeoutClass_t type, char *response);
+		void	learnLatency(timeoutClass_t type, unsigned long elapsed);
+		void	resetLatency(timeoutClass_t type, unsigned int initial, 
+											 unsigned int ceiling);
+#if WISMO228_CLOCK
+		bool	updateTime();
+		unsigned long	clockToEpoch(const char *clock);
+#endif
+		bool	readSignal(int *rssi, unsigned char *ber);
+		void	sampleSignal();
 		int	  rssiToDbm(int	rssi);
+#if WISMO228_EMAIL
 		void	encodeBase64(const char *input, char *output);
+		bool	encodeBase64(unsigned int (*source)(char *data, 
+											unsigned int size));
+		void	encodeBase64Group(const char *raw, unsigned char length, 
+														char *encoded);
+#endif
 		void	readFlash(char *sourcePtr, char *targetPtr);
 		
 		Stream *uart;
@@ -82,5 +426,81 @@ class WISMO228
 		unsigned char	_onOffPin;
 		unsigned char	_ringPin;
 		status_t	status;
+#if WISMO228_GPRS
+		dataMode_t	dataMode;
+		unsigned	char	socketsOpen;
+		const char	*linkApn;
+		const char	*linkUsername;
+		const char	*linkPassword;
+		unsigned	long	linkInterval;
+		unsigned	long	linkChecked;
+		unsigned	long	linkPeriod;
+		unsigned	char	linkAttempts;
+		unsigned	int	linkDrops;
+#endif
+#if WISMO228_UDP
+		unsigned int	udpSequence;
+		unsigned int	udpLost;
+#endif
+#if WISMO228_SERVER
+		void	(*acceptFunctionPtr)(unsigned char socket);
+#endif
+#if WISMO228_MQTT
+		void	(*mqttFunctionPtr)(const char *topic, const char *payload);
+		unsigned int	mqttKeepAlive;
+		unsigned int	mqttPacketId;
+		unsigned long	mqttLastSent;
+#endif
+#if WISMO228_FTP
+		unsigned long	ftpBytes;
+		unsigned long	ftpDuration;
+#endif
+#if WISMO228_EMAIL
+		const char	*emailSender;
+		bool	smtpPipelining;
+		unsigned	char	smtpStart;
+		unsigned	char	smtpBuffered;
+#endif
+#if WISMO228_GPRS
+		dnsEntry_t	dnsCache[DNS_CACHE_SIZE];
+#endif
+#if WISMO228_PING
+		pingStats_t	pingStats;
+		unsigned	int	pingLast;
+		unsigned	long	pingSum;
+		unsigned	long	pingJitterSum;
+#endif
+		unsigned	long	signalInterval;
+		unsigned	long	signalSampled;
+		int	signalThreshold;
+		int	signalAverage;
+		int	signalRecent;
+		int	berAverage;
+		unsigned	char	signalSamples;
+		unsigned	char	berSamples;
+		latency_t	latency[TIMEOUT_CLASSES];
+		retryPolicy_t	retryPolicy;
+		bool	retryCancelled;
+		atCommand_t	commandQueue[COMMAND_QUEUE_MAX];
+		unsigned	char	commandCount;
+		unsigned	char	configShadow;
+		unsigned	int	bearerHash;
+		unsigned	int	configAddress;
+#if WISMO228_SMS
+		unsigned	int	smsRate;
+		unsigned	char	smsCleanup;
+		unsigned	int	whitelistAddress;
+		unsigned	char	whitelistSlots;
+#endif
+		void	(*idleFunctionPtr)(void);
+#if WISMO228_CLOCK
+		bool	timeSynced;
+		unsigned	long	timeEpoch;
+		unsigned	long	timeMillis;
+		unsigned	long	timeChecked;
+		unsigned	long	timeInterval;
+		long	timeDrift;
+		int	timeZone;
+#endif
 };
 #endif
\ No newline at end of file
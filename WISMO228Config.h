@@ -0,0 +1,67 @@
+/*******************************************************************************
+* WISMO228 Library Configuration
+* Version: 1.40
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* Feature switches of the WISMO228 library. Set a feature to 0 to leave its 
+* code, flash memory strings & RAM out of the build when the sketch does not use
+* it. Refer to Readme.txt for the flash & RAM cost of each feature.
+*
+* The switches are only set here. The library & every sketch must see the same
+* values, otherwise they disagree on the layout of the WISMO228 class.
+*
+* Features marked as GPRS require WISMO228_GPRS.
+*
+* This library is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*******************************************************************************/
+#ifndef WISMO228Config_h
+#define WISMO228Config_h
+
+#if defined(WISMO228_SMS) || defined(WISMO228_CLOCK) || \
+	defined(WISMO228_GPRS) || defined(WISMO228_HTTP) || \
+	defined(WISMO228_EMAIL) || defined(WISMO228_PING) || \
+	defined(WISMO228_SERVER) || defined(WISMO228_UDP) || \
+	defined(WISMO228_MQTT) || defined(WISMO228_FTP)
+#error "WISMO228 feature switches are set in WISMO228Config.h only"
+#endif
+
+// SMS send, receive, storage, whitelist & command dispatcher
+#define	WISMO228_SMS	1
+
+// Module clock & local timebase
+#define	WISMO228_CLOCK	1
+
+// GPRS bearer, DNS cache & TCP client socket
+#define	WISMO228_GPRS	1
+
+// HTTP GET & PUT (GPRS)
+#define	WISMO228_HTTP	1
+
+// SMTP email with attachment (GPRS)
+#define	WISMO228_EMAIL	1
+
+// Ping & ping series (GPRS)
+#define	WISMO228_PING	1
+
+// TCP server (GPRS)
+#define	WISMO228_SERVER	1
+
+// UDP client (GPRS)
+#define	WISMO228_UDP	1
+
+// MQTT client (GPRS)
+#define	WISMO228_MQTT	1
+
+// FTP upload (GPRS)
+#define	WISMO228_FTP	1
+
+#if !WISMO228_GPRS && (WISMO228_HTTP || WISMO228_EMAIL || WISMO228_PING || \
+	WISMO228_SERVER || WISMO228_UDP || WISMO228_MQTT || WISMO228_FTP)
+#error "WISMO228 GPRS based features require WISMO228_GPRS"
+#endif
+
+#endif
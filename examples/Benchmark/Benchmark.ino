@@ -0,0 +1,456 @@
+/*******************************************************************************
+* WISMO228 Library - Benchmark Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is a benchmark of the WISMO228 library CPU usage. The WISMO228 module is
+* replaced by a simulated module replying from flash memory, so no shield is 
+* required and every run is repeatable. Each operation is timed in CPU cycles 
+* with Timer1 and the free RAM is reported at the end. Run it before & after a 
+* library change on the same board to catch regressions. An operation which does
+* not succeed against the simulated module is reported as failed, as its cycle
+* count does not describe the normal path. The fixed quiet time of transparent 
+* data mode before the "+++" escape sequence is idle waiting and is reported
+* apart from the cycle count.
+*
+* Flash & RAM usage of the whole sketch is reported by the Arduino IDE after 
+* compiling ("Sketch uses ... bytes").
+*
+* ============
+* Requirements
+* ============
+* 1. Any ATmega328P or ATmega2560 based board. Shield is not required.
+* 2. Serial monitor at 9600 baud.
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial public release. Uses WISMO228 Library version 1.40.
+*******************************************************************************/
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+// Not connected to a module, only pulsed during power up
+const  uint8_t  gsmOnOffPin = A2;
+
+// ***** SIMULATED WISMO228 REPLIES *****
+const char  powerUpReply[] PROGMEM = "\r\nOK\r\n"
+                                     "\r\n+CPIN: READY\r\n\r\nOK\r\n"
+                                     "\r\n+CREG: 0,1\r\n\r\nOK\r\n"
+                                     "\r\nOK\r\n";
+const char  rssiReply[] PROGMEM = "\r\n+CSQ: 20,0\r\n\r\nOK\r\n";
+const char  clockReply[] PROGMEM = "\r\n+CCLK: \"26/10/18,12:00:00+32\"\r\n"
+                                   "\r\nOK\r\n";
+const char  smsReply[] PROGMEM = "\r\n+CMGL: 1,\"REC UNREAD\",\"+60123456789\","
+                                 "\"\",\"26/10/18,12:00:00+32\"\r\n"
+                                 "0123456789012345678901234567890123456789"
+                                 "0123456789012345678901234567890123456789"
+                                 "0123456789012345678901234567890123456789"
+                                 "0123456789012345678901234567890123456789"
+                                 "\r\n\r\nOK\r\n\r\nOK\r\n";
+const char  gprsReply[] PROGMEM = "\r\nOK\r\n\r\nOK\r\n";
+// 64 bytes of page, in one block or as a transparent stream
+const char  httpBlockReply[] PROGMEM = "\r\n+WIPREADY: 2,1\r\n"
+                                       "\r\n> \r\nOK\r\n"
+                                       "\r\n+WIPDATARW: 2,1,64\r\n"
+                                       "HTTP/1.1 200 OK\r\n"
+                                       "Content-Length: 25\r\n"
+                                       "\r\n"
+                                       "0123456789012345678901234"
+                                       "\r\nOK\r\n"
+                                       "\r\nOK\r\n";
+const char  httpStreamReply[] PROGMEM = "\r\n+WIPREADY: 2,1\r\n"
+                                        "\r\nCONNECT\r\n"
+                                        "HTTP/1.1 200 OK\r\n"
+                                        "Content-Length: 25\r\n"
+                                        "\r\n"
+                                        "0123456789012345678901234";
+// Replies to the escape sequence & socket close after the quiet time
+const char  httpEscapeReply[] PROGMEM = "\r\nOK\r\n"
+                                        "\r\nOK\r\n";
+const char  emailOpenReply[] PROGMEM = "\r\n+WIPREADY: 2,6\r\n"
+                                       "\r\nCONNECT\r\n"
+                                       "220 smtp\r\n"
+                                       "250 AUTH LOGIN\r\n"
+                                       "334 VXNlcm5hbWU6\r\n"
+                                       "334 UGFzc3dvcmQ6\r\n"
+                                       "235 ok\r\n";
+const char  emailSendReply[] PROGMEM = "250 ok\r\n"
+                                       "250 ok\r\n"
+                                       "354 go\r\n"
+                                       "250 ok\r\n";
+const char  emailCloseReply[] PROGMEM = "221 bye\r\n"
+                                        "\r\nOK\r\n"
+                                        "\r\nOK\r\n";
+#define HTTP_REPLY_SIZE   64
+#define ATTACHMENT_SIZE   512
+
+// ***** COMMAND KEYWORDS & TABLE *****
+const char  keywordAlarm[] PROGMEM = "ALARM";
+const char  keywordLed[] PROGMEM = "LED";
+const char  keywordStatus[] PROGMEM = "STATUS";
+void    emptyCommand(const char *, const char *);
+const smsCommand_t  commands[] PROGMEM = 
+{
+  {keywordAlarm, emptyCommand},
+  {keywordLed, emptyCommand},
+  {keywordStatus, emptyCommand}
+};
+
+// ***** EMAIL RECIPIENT *****
+const char  *recipient = "someone@example.com";
+
+// ***** CLASSES *****
+// Simulated WISMO228 module, replies with the loaded string whatever the 
+// command and discards everything written to it. With a next reply, Timer1 is
+// stopped once the first reply is read and started again by the next write 
+// (which loads the next reply), so the library waiting idle in between is not 
+// counted. The idle time is kept in idleTime (ms).
+class FakeModem : public Stream
+{
+  public:
+    void  reply(const char *flashReply, const char *flashNext = NULL)
+    {
+      replyPtr = flashReply;
+      remaining = strlen_P(flashReply);
+      nextPtr = flashNext;
+      idle = false;
+    }
+    
+    int available()
+    {
+      return (remaining);
+    }
+    
+    int read()
+    {
+      int rxByte = peek();
+      
+      if (rxByte >= 0)
+      {
+        replyPtr++;
+        remaining--;
+        
+        if ((remaining == 0) && (nextPtr != NULL))
+        {
+          // Stop Timer1 until the library writes again
+          TCCR1B = 0;
+          idleStart = millis();
+          idle = true;
+        }
+      }
+      
+      return (rxByte);
+    }
+    
+    int peek()
+    {
+      return ((remaining > 0) ? pgm_read_byte(replyPtr) : -1);
+    }
+    
+    void  flush()
+    {
+    }
+    
+    size_t  write(uint8_t)
+    {
+      if (idle)
+      {
+        idleTime = millis() - idleStart;
+        reply(nextPtr);
+        TCCR1B = _BV(CS10);
+      }
+      
+      return (1);
+    }
+    
+    unsigned long idleTime;
+  
+  private:
+    const char *replyPtr;
+    const char *nextPtr;
+    int remaining;
+    bool  idle;
+    unsigned long idleStart;
+};
+
+FakeModem modem;
+// WISMO228 class
+WISMO228 wismo(&modem, gsmOnOffPin);
+
+// ***** VARIABLES *****
+volatile unsigned int  overflows;
+bool  passed;
+unsigned int  attachmentLeft;
+
+void setup()  
+{
+  Serial.begin(9600);
+  Serial.println("Benchmark Example");
+  
+  // Timer1 counts CPU cycles (no prescaler)
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TIMSK1 = _BV(TOIE1);
+  
+  // Initialize WISMO228
+  wismo.init();
+  
+  modem.reply(powerUpReply);
+  
+  if (wismo.powerUp())
+  {
+    report("getRssi", measure(benchRssi));
+    report("getClock", measure(benchGetClock));
+    
+    modem.reply(clockReply);
+    wismo.syncTime(false, 0);
+    report("getTime", measure(benchGetTime));
+    
+    report("readSms (160 chars)", measure(benchReadSms));
+    report("dispatchSms", measure(benchDispatch));
+    
+    // GPRS operations last, they need the bearer started
+    modem.reply(gprsReply);
+    
+    if (wismo.openGPRS("apn", "user", "password"))
+    {
+      wismo.setDataMode(DATA_BLOCK);
+      report("getHttp block (64 bytes)", measure(benchGetHttp));
+      wismo.setDataMode(DATA_TRANSPARENT);
+      // Quiet time before leaving data mode is idle waiting, not counted
+      report("getHttp transparent (64 bytes)", measure(benchStreamHttp));
+      Serial.print("getHttp transparent escape guard: ");
+      Serial.print(modem.idleTime);
+      Serial.println(" ms (not counted)");
+      
+      modem.reply(emailOpenReply);
+      
+      if (wismo.openEmail("10.1.2.4", "25", "user", "password"))
+      {
+        report("sendEmail (512 bytes attachment)", measure(benchSendEmail));
+        modem.reply(emailCloseReply);
+        wismo.closeEmail();
+      }
+      else
+      {
+        Serial.println("openEmail: failed");
+      }
+    }
+    else
+    {
+      Serial.println("openGPRS: failed");
+    }
+    
+    Serial.print("Free RAM: ");
+    Serial.println(freeRam());
+  }
+  else
+  {
+    Serial.println("Ugh, simulated power up failed.");
+  }
+}
+
+void loop()                 
+{
+}
+
+/*******************************************************************************
+* Name: measure
+* Description: Run an operation and count the CPU cycles it takes. Its result
+*              is kept in passed.
+*
+* Argument     Description
+* =========    ===========
+* 1. operation Operation to run, returns true if it succeeded.
+*
+* Return       Description
+* =========	   ===========
+* 1. cycles    CPU cycles taken including interrupts (millis).
+*
+*******************************************************************************/
+unsigned long measure(bool (*operation)(void))
+{
+  unsigned long cycles;
+  
+  noInterrupts();
+  overflows = 0;
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  interrupts();
+  
+  passed = operation();
+  
+  noInterrupts();
+  cycles = TCNT1;
+  // Account for an overflow not serviced yet
+  if (TIFR1 & _BV(TOV1))
+  {
+    overflows++;
+    cycles = TCNT1;
+    TIFR1 = _BV(TOV1);
+  }
+  cycles += (unsigned long)overflows << 16;
+  interrupts();
+  
+  return (cycles);
+}
+
+/*******************************************************************************
+* Name: report
+* Description: Print the result of the last measured operation.
+*
+* Argument     Description
+* =========    ===========
+* 1. name      Name of the operation.
+*
+* 2. cycles    CPU cycles taken.
+*
+* Return       Description
+* =========	   ===========
+* 1. NIL			
+*
+*******************************************************************************/
+void    report(const char *name, unsigned long cycles)
+{
+  Serial.print(name);
+  Serial.print(": ");
+  
+  if (passed)
+  {
+    Serial.print(cycles);
+    Serial.print(" cycles (");
+    Serial.print(cycles / (F_CPU / 1000000UL));
+    Serial.println(" us)");
+  }
+  else
+  {
+    Serial.println("failed");
+  }
+}
+
+bool    benchRssi(void)
+{
+  modem.reply(rssiReply);
+  return (wismo.getRssi() != 0);
+}
+
+bool    benchGetClock(void)
+{
+  char  clock[CLOCK_COUNT_MAX + 1];
+  
+  modem.reply(clockReply);
+  return (wismo.getClock(clock));
+}
+
+bool    benchGetTime(void)
+{
+  return (wismo.getTime() != 0);
+}
+
+bool    benchReadSms(void)
+{
+  char  sender[SENDER_LENGTH_MAX];
+  char  message[SMS_LENGTH_MAX + 1];
+  
+  modem.reply(smsReply);
+  return (wismo.readSms(sender, message));
+}
+
+bool    benchDispatch(void)
+{
+  char  message[] = "STATUS now";
+  
+  return (wismo.dispatchSms(commands, sizeof(commands) / sizeof(commands[0]), 
+                            "60123456789", message));
+}
+
+bool    benchGetHttp(void)
+{
+  char  page[HTTP_REPLY_SIZE];
+  
+  modem.reply(httpBlockReply);
+  return (wismo.getHttp("10.1.2.3", "/", "80", page, sizeof(page)));
+}
+
+bool    benchStreamHttp(void)
+{
+  char  page[HTTP_REPLY_SIZE];
+  
+  modem.reply(httpStreamReply, httpEscapeReply);
+  return (wismo.getHttp("10.1.2.3", "/", "80", page, sizeof(page)));
+}
+
+bool    benchSendEmail(void)
+{
+  attachmentLeft = ATTACHMENT_SIZE;
+  modem.reply(emailSendReply);
+  return (wismo.sendEmail(&recipient, 1, "Log", "Log attached.", "log.csv", 
+                          readAttachment));
+}
+
+/*******************************************************************************
+* Name: readAttachment
+* Description: Attachment source of the sendEmail benchmark, base 64 encoded by
+*              the library.
+*
+* Argument     Description
+* =========    ===========
+* 1. data      Location to store the next part of the attachment.
+*
+* 2. size      Maximum number of bytes to store.
+*
+* Return       Description
+* =========    ===========
+* 1. count     Number of bytes stored, 0 at the end of the attachment.
+*
+*******************************************************************************/
+unsigned int readAttachment(char *data, unsigned int size)
+{
+  unsigned int  count = 0;
+  
+  while ((count < size) && (attachmentLeft > 0))
+  {
+    data[count++] = '0' + (attachmentLeft % 10);
+    attachmentLeft--;
+  }
+  
+  return (count);
+}
+
+void    emptyCommand(const char *, const char *)
+{
+}
+
+/*******************************************************************************
+* Name: freeRam
+* Description: Free RAM between the heap and the stack.
+*
+* Argument     Description
+* =========    ===========
+* 1. NIL
+*
+* Return       Description
+* =========	   ===========
+* 1. bytes     Free RAM in bytes.
+*
+*******************************************************************************/
+int     freeRam(void)
+{
+  extern int __heap_start, *__brkval; 
+  int v; 
+  
+  return ((int)&v - (__brkval == 0 ? (int)&__heap_start : (int)__brkval)); 
+}
+
+ISR(TIMER1_OVF_vect)
+{
+  overflows++;
+}
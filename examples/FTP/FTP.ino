@@ -0,0 +1,145 @@
+/*******************************************************************************
+* WISMO228 Library - FTP Upload Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is an example on uploading logged data to a FTP server in a single 
+* session using the WISMO228 library on the TraLog Shield. The file content is
+* produced on the fly by a data source function, replace it with reads from 
+* your SD card or external flash.
+*
+* ============
+* Requirements
+* ============
+* 1. UART selection switch to SW position (uses pin D5 (RX) & D6 (TX)).
+* 2. On v1 of the shield, jumper J14 is closed to allow usage of pin A2 to 
+*    control on-off state of WISMO228 module. On v2 of the shield, short the 
+*    jumper labelled A2 & GSM-ON. This is the default factory setting.
+* 3. You need to know your service provider APN name, username, and password. If
+*    they don't specify the username and password, you can use " ". Notice the
+*    space in between the quote mark. 
+* 4. A FTP server account with write access.
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial public release. Uses WISMO228 Library version 1.40.
+*******************************************************************************/
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+const  uint8_t  gsmRxPin = 5;
+const  uint8_t  gsmTxPin = 6;
+const  uint8_t  gsmOnOffPin = A2;
+
+// ***** CONSTANTS *****
+const  char  apn[] = "apn";
+const  char  username[] = "username";
+const  char  password[] = "password";
+// ***** FTP PARAMETERS *****
+const  char  ftpServer[] = "ftp.yourdomain.com";
+const  char  ftpPort[] = "21";
+const  char  ftpUsername[] = "username";
+const  char  ftpPassword[] = "password";
+const  char  filename[] = "log.csv";
+// Number of log records to upload
+#define RECORD_COUNT  500
+
+// ***** CLASSES *****
+// Software serial class
+SoftwareSerial gsm(gsmRxPin, gsmTxPin); 
+// WISMO228 class
+WISMO228  wismo(&gsm, gsmOnOffPin);
+
+// ***** VARIABLES *****
+unsigned int  record;
+
+void setup()  
+{
+  Serial.begin(9600);
+  Serial.println(F("FTP Upload Example"));
+
+  // Initialize WISMO228
+  wismo.init();
+  
+  Serial.println(F("Powering up, please wait..."));
+  
+  // Perform WISMO228 power up sequence
+  if (wismo.powerUp())
+  {
+    Serial.println(F("TraLog is awake!"));
+    
+    if (wismo.openGPRS(apn, username, password))
+    {
+      Serial.println(F("Connected to GPRS."));
+      
+      record = 0;
+      
+      if (wismo.ftpUpload(ftpServer, ftpPort, ftpUsername, ftpPassword, 
+                          filename, readLog))
+      {
+        Serial.print(F("Uploaded at "));
+        Serial.print(wismo.getFtpThroughput());
+        Serial.println(F(" bytes/s"));
+      }
+      else
+      {
+        Serial.println(F("Upload failed."));
+      }
+      
+      wismo.closeGPRS();
+    }
+    else
+    {
+      Serial.println(F("GPRS connection failed."));
+    }
+  }
+  else
+  {
+    Serial.println(F("Ugh, power up failed."));
+  }
+}
+
+void loop() 
+{  
+  // Let's count sheep instead
+}
+
+/*******************************************************************************
+* Name: readLog
+* Description: Data source of the uploaded file, one record per call.
+*
+* Argument     Description
+* =========    ===========
+* 1. data      Location to store the file content.
+* 2. size      Maximum number of bytes to store.
+*
+* Return       Description
+* =========	   ===========
+* 1. count     Number of bytes stored, 0 at the end of the file.
+*
+*******************************************************************************/
+unsigned int readLog(char *data, unsigned int size)
+{
+  unsigned int  count = 0;
+  
+  // Record format: index,value\r\n (fits in the smallest buffer)
+  if ((record < RECORD_COUNT) && (size >= 16))
+  {
+    itoa(record, data, 10);
+    strcat(data, ",");
+    itoa(record * 3, data + strlen(data), 10);
+    strcat(data, "\r\n");
+    count = strlen(data);
+    record++;
+  }
+  
+  return (count);
+}
@@ -0,0 +1,156 @@
+/*******************************************************************************
+* WISMO228 Library - MQTT Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is an example on publishing sensor readings to a MQTT broker and 
+* receiving commands pushed by the broker using the WISMO228 library on the 
+* TraLog Shield. A single socket is kept open with the broker, each reading 
+* costs a single PUBLISH packet.
+*
+* ============
+* Requirements
+* ============
+* 1. UART selection switch to SW position (uses pin D5 (RX) & D6 (TX)).
+* 2. On v1 of the shield, jumper J14 is closed to allow usage of pin A2 to 
+*    control on-off state of WISMO228 module. On v2 of the shield, short the 
+*    jumper labelled A2 & GSM-ON. This is the default factory setting.
+* 3. You need to know your service provider APN name, username, and password. If
+*    they don't specify the username and password, you can use " ". Notice the
+*    space in between the quote mark. 
+* 4. A MQTT broker reachable from the GPRS network.
+* 5. An analog sensor connected to pin A5. You can use an LDR for this example.
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial public release. Uses WISMO228 Library version 1.40.
+*******************************************************************************/
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+const  uint8_t  gsmRxPin = 5;
+const  uint8_t  gsmTxPin = 6;
+const  uint8_t  gsmOnOffPin = A2;
+const  uint8_t  sensorPin = A5;
+
+// ***** CONSTANTS *****
+const  char  apn[] = "apn";
+const  char  username[] = "username";
+const  char  password[] = "password";
+// ***** MQTT PARAMETERS *****
+const  char  broker[] = "broker.yourdomain.com";
+const  char  brokerPort[] = "1883";
+const  char  clientId[] = "tralog";
+const  char  sensorTopic[] = "tralog/sensor";
+const  char  commandTopic[] = "tralog/command";
+#define KEEP_ALIVE  120
+#define UPDATE_INTERVAL 60000
+
+// ***** CLASSES *****
+// Software serial class
+SoftwareSerial gsm(gsmRxPin, gsmTxPin); 
+// WISMO228 class
+WISMO228  wismo(&gsm, gsmOnOffPin);
+
+// ***** VARIABLES *****
+unsigned long scheduler;
+
+void setup()  
+{
+  Serial.begin(9600);
+  Serial.println(F("MQTT Example"));
+
+  // Initialize WISMO228
+  wismo.init();
+  
+  Serial.println(F("Powering up, please wait..."));
+  
+  // Perform WISMO228 power up sequence
+  if (wismo.powerUp())
+  {
+    Serial.println(F("TraLog is awake!"));
+    
+    if (wismo.openGPRS(apn, username, password))
+    {
+      Serial.println(F("Connected to GPRS."));
+      
+      // Handler of messages pushed by the broker
+      wismo.setMqttCallback(newCommand);
+      
+      if (wismo.mqttConnect(broker, brokerPort, clientId, NULL, NULL, 
+                            KEEP_ALIVE))
+      {
+        Serial.println(F("Connected to broker."));
+        
+        if (wismo.mqttSubscribe(commandTopic, 1))
+        {
+          Serial.println(F("Subscribed to commands."));
+        }
+      }
+    }
+    else
+    {
+      Serial.println(F("GPRS connection failed."));
+    }
+  }
+  else
+  {
+    Serial.println(F("Ugh, power up failed."));
+  }
+  
+  scheduler = millis();
+}
+
+void loop() 
+{  
+  char  data[8];
+  
+  // Process commands & keep the session alive
+  if (!wismo.mqttLoop())
+  {
+    Serial.println(F("Broker not responding."));
+  }
+  
+  if (millis() > scheduler)
+  {
+    scheduler = millis() + UPDATE_INTERVAL;
+    
+    // Read sensor & convert from int to string
+    itoa(analogRead(sensorPin), data, 10);
+    
+    if (wismo.mqttPublish(sensorTopic, data, 0))
+    {
+      Serial.print(F("Published: "));
+      Serial.println(data);
+    }
+  }
+}
+
+/*******************************************************************************
+* Name: newCommand
+* Description: A handler for messages pushed by the broker.
+*
+* Argument     Description
+* =========    ===========
+* 1. topic     Topic of the message.
+* 2. payload   Content of the message.
+*
+* Return       Description
+* =========	   ===========
+* 1. NIL			
+*
+*******************************************************************************/
+void newCommand(const char *topic, const char *payload)
+{
+  Serial.print(topic);
+  Serial.print(F(": "));
+  Serial.println(payload);
+}
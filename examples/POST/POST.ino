@@ -0,0 +1,212 @@
+/*******************************************************************************
+* WISMO228 Library - HTTP POST Streaming Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is an example on how to upload a log stored in EEPROM using HTTP POST
+* request over GPRS. The log is streamed to the server in chunks, so it never
+* needs to fit in RAM.
+*
+* ============
+* Requirements
+* ============
+* 1. UART selection switch to SW position (uses pin D5 (RX) & D6 (TX)).
+* 2. On v1 of the shield, jumper J14 is closed to allow usage of pin A2 to
+*    control on-off state of WISMO228 module. On v2 of the shield, short the
+*    jumper labelled A2 & GSM-ON. This is the default factory setting.
+* 3. You need to know your service provider APN name, username, and password.
+*    If they don't specify the username and password, you can use " ". Notice
+*    the space in between the quote mark.
+* 4. A HTTP server accepting POST requests on the specified path.
+*
+* ============
+* Instructions
+* ============
+* 1. Replace the GPRS & server parameters to suit your setup.
+* 2. The log is the text stored in EEPROM from address 0 up to the first 0 or
+*    0xFF byte. Use HTTP_LENGTH_UNKNOWN as the length if the size of your data
+*    is not known before the upload (chunked transfer encoding).
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0
+* Unported License.
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial release. Uses WISMO228 Library version 1.40.
+******************************************************************************/
+// ***** COMPILE OPTIONS *****
+#define DEBUG
+
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <avr/eeprom.h>
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+const  uint8_t  gsmRxPin = 5;
+const  uint8_t  gsmTxPin = 6;
+const  uint8_t  gsmOnOffPin = A2;
+
+// ***** CONSTANTS *****
+// ***** GPRS PARAMATERS *****
+const  char  apn[] = "InsertYourApn";
+const  char  username[] = "InserYourUsername";
+const  char  password[] = "InsertYourPassword";
+// ***** SERVER PARAMATERS *****
+const  char server[] = "InsertYourServer";
+const  char path[] = "/log";
+const  char port[] = "80";
+const  char host[] = "InsertYourServer";
+const  char contentType[] = "text/plain";
+#define LOG_SIZE_MAX  (E2END + 1)
+
+// ***** CLASSES *****
+// Software serial class
+SoftwareSerial gsm(gsmRxPin, gsmTxPin);
+// WISMO228 class
+WISMO228  wismo(&gsm, gsmOnOffPin);
+
+// ***** VARIABLES *****
+unsigned int  logAddress;
+
+void setup()
+{
+  // Use hardware serial to track the progress of task execution
+  #ifdef DEBUG
+    Serial.begin(9600);
+    Serial.println(F("HTTP POST Streaming Example"));
+    Serial.println(F("Powering up GSM, please wait..."));
+  #endif
+
+  // Initialize WISMO228
+  wismo.init();
+
+  // Perform WISMO228 power up sequence
+  if (wismo.powerUp())
+  {
+    #ifdef DEBUG
+      Serial.println(F("GSM is awake."));
+    #endif
+
+    uploadLog();
+  }
+}
+
+void loop()
+{
+}
+
+void uploadLog(void)
+{
+  // Connect to GPRS network
+  if (wismo.openGPRS(apn, username, password))
+  {
+    #ifdef DEBUG
+      Serial.println(F("GPRS OK."));
+      Serial.println(F("Uploading log, please wait..."));
+    #endif
+
+    // Stream the log from the beginning of EEPROM
+    logAddress = 0;
+
+    if (wismo.postHttp(server, path, port, host, NULL, contentType,
+                       logLength(), readLog))
+    {
+      #ifdef DEBUG
+        Serial.println(F("Log uploaded!"));
+      #endif
+    }
+    else
+    {
+      #ifdef DEBUG
+        Serial.println(F("Unable to upload log."));
+      #endif
+    }
+
+    // Close the GPRS connection
+    if (wismo.closeGPRS())
+    {
+      #ifdef DEBUG
+        Serial.println(F("GPRS closed."));
+      #endif
+    }
+  }
+  else
+  {
+    #ifdef DEBUG
+      Serial.println(F("GPRS failed."));
+    #endif
+  }
+}
+
+/*******************************************************************************
+* Name: logLength
+* Description: Length of the log stored in EEPROM.
+*
+* Argument     Description
+* =========    ===========
+* 1. NIL
+*
+* Return       Description
+* =========    ===========
+* 1. length    Number of characters in the log.
+*
+*******************************************************************************/
+unsigned long logLength(void)
+{
+  unsigned int  length = 0;
+  uint8_t  data;
+
+  while (length < LOG_SIZE_MAX)
+  {
+    data = eeprom_read_byte((uint8_t *)length);
+
+    if ((data == 0x00) || (data == 0xFF))
+    {
+      break;
+    }
+    length++;
+  }
+
+  return (length);
+}
+
+/*******************************************************************************
+* Name: readLog
+* Description: Data source of the upload, called by the library until it
+*              returns 0.
+*
+* Argument     Description
+* =========    ===========
+* 1. data      Location to store the next part of the log.
+*
+* 2. size      Maximum number of characters to store.
+*
+* Return       Description
+* =========    ===========
+* 1. count     Number of characters stored, 0 at the end of the log.
+*
+*******************************************************************************/
+unsigned int readLog(char *data, unsigned int size)
+{
+  unsigned int  count = 0;
+  uint8_t  value;
+
+  while ((count < size) && (logAddress < LOG_SIZE_MAX))
+  {
+    value = eeprom_read_byte((uint8_t *)logAddress);
+
+    if ((value == 0x00) || (value == 0xFF))
+    {
+      break;
+    }
+
+    data[count++] = value;
+    logAddress++;
+  }
+
+  return (count);
+}
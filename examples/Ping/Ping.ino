@@ -1,12 +1,14 @@
 /*******************************************************************************
 * WISMO228 Library - Ping Example
-* Version: 1.10
-* Date: 09-07-2013
+* Version: 1.20
+* Date: 18-10-2026
 * Company: Rocket Scream Electronics
 * Author: Lim Phang Moh
 * Website: www.rocketscream.com
 *
 * This is an example on ping using the WISMO228 library on the TraLog Shield.
+* A single ping is followed by a series of pings which characterises the link
+* quality (round trip time, jitter & loss) without blocking the sketch.
 *
 * ============
 * Requirements
@@ -24,6 +26,7 @@
 *
 * Revision  Description
 * ========  ===========
+* 1.20      Added ping series statistics. Uses WISMO228 Library version 1.40.
 * 1.10      Updated to support WISMO228 Library version 1.20.
 *           Tested up to Arduino IDE 1.0.4.
 * 1.00      Initial public release. Tested with L22 & L23 of WISMO228 firmware.
@@ -43,6 +46,9 @@ const  char  apn[] = "apn";
 const  char  username[] = "username";
 const  char  password[] = "password";
 
+// ***** VARIABLES *****
+bool  series = false;
+
 // ***** CLASSES *****
 // Software serial class
 SoftwareSerial gsm(gsmRxPin, gsmTxPin); 
@@ -75,11 +81,12 @@ void setup()
       Serial.print("Ping result: ");
       Serial.print(wismo.ping("www.google.com"));
       Serial.println(" ms");
-
-      // Close the GPRS connection
-      if (wismo.closeGPRS())
+      
+      // 10 pings of 32 bytes, 1 s apart
+      if (wismo.startPing("www.google.com", 10, 32, 1000))
       {
-        Serial.println("GPRS connection closed.");
+        Serial.println("Ping series started.");
+        series = true;
       }
     }
     else
@@ -95,5 +102,34 @@ void setup()
 
 void loop() 
 {  
-  // Let's count sheep instead
+  pingStats_t stats;
+  
+  // Process ping replies as they arrive
+  wismo.poll();
+  
+  if (series && wismo.getPingStats(&stats))
+  {
+    series = false;
+    
+    Serial.print("Received: ");
+    Serial.print(stats.received);
+    Serial.print("/");
+    Serial.println(stats.sent);
+    Serial.print("Min/Avg/Max: ");
+    Serial.print(stats.minimum);
+    Serial.print("/");
+    Serial.print(stats.average);
+    Serial.print("/");
+    Serial.print(stats.maximum);
+    Serial.println(" ms");
+    Serial.print("Jitter: ");
+    Serial.print(stats.jitter);
+    Serial.println(" ms");
+    
+    // Close the GPRS connection
+    if (wismo.closeGPRS())
+    {
+      Serial.println("GPRS connection closed.");
+    }
+  }
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 /*******************************************************************************
 * WISMO228 Library - Receive SMS Example
-* Version: 1.10
-* Date: 09-07-2013
+* Version: 1.20
+* Date: 18-10-2026
 * Company: Rocket Scream Electronics
 * Author: Lim Phang Moh
 * Website: www.rocketscream.com
@@ -25,6 +25,8 @@
 *
 * Revision  Description
 * ========  ===========
+* 1.20      Uses module memory for SMS storage if available & cleans up the 
+*           storage before it fills up. Uses WISMO228 Library version 1.40.
 * 1.10      Updated to support WISMO228 Library version 1.20.
 *           Tested up to Arduino IDE 1.0.4.
 * 1.00      Initial public release. Tested with L22 & L23 of WISMO228 firmware.
@@ -63,6 +65,16 @@ void setup()
   if (wismo.powerUp())
   {
     Serial.println("TraLog is awake!");
+    
+    // Module memory holds more messages than the SIM card
+    if (wismo.selectSmsStorage())
+    {
+      Serial.println("Using module memory for SMS");
+    }
+    
+    // Remove read messages once the storage is 80% full
+    wismo.setSmsCleanup(80);
+    
     Serial.println("Try sending some SMS to TraLog!");
   }
   else
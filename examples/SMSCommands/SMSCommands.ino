@@ -0,0 +1,178 @@
+/*******************************************************************************
+* WISMO228 Library - SMS Commands Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is an example on controlling the TraLog Shield remotely through SMS 
+* commands using the WISMO228 library. Send "LED ON", "LED OFF" or "STATUS" to
+* the TraLog Shield.
+*
+* ============
+* Requirements
+* ============
+* 1. UART selection switch to SW position (uses pin D5 (RX) & D6 (TX)).
+* 2. On v1 of the shield, jumper J14 is closed to allow usage of pin A2 to 
+*    control on-off state of WISMO228 module. On v2 of the shield, short the 
+*    jumper labelled A2 & GSM-ON. This is the default factory setting.
+* 3. On v1 of the shield, jumper J15 is closed to allow usage of pin D2 as 
+*    interupt source of the RI signal on WISMO228 module. On v2 of the shield, 
+*    short the jumper labelled D2 & RI.
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial public release. Uses WISMO228 Library version 1.40.
+*******************************************************************************/
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+const  uint8_t  gsmRxPin = 5;
+const  uint8_t  gsmTxPin = 6;
+const  uint8_t  gsmOnOffPin = A2;
+const  uint8_t  gsmRingPin = 2;
+const  uint8_t  ledPin = 13;
+
+// ***** COMMAND KEYWORDS *****
+const char  keywordLed[] PROGMEM = "LED";
+const char  keywordStatus[] PROGMEM = "STATUS";
+
+// ***** COMMAND TABLE *****
+// Upper case keywords sorted in ascending order of character codes (strcmp)
+const smsCommand_t  commands[] PROGMEM = 
+{
+  {keywordLed, ledCommand},
+  {keywordStatus, statusCommand}
+};
+
+// ***** VARIABLES *****
+volatile bool    sms = false;
+
+// ***** CLASSES *****
+// Software serial class
+SoftwareSerial gsm(gsmRxPin, gsmTxPin); 
+// WISMO228 class
+WISMO228 wismo(&gsm, gsmOnOffPin, gsmRingPin, newSms);
+
+void setup()  
+{
+  pinMode(ledPin, OUTPUT);
+  
+  Serial.begin(9600);
+  Serial.println("SMS Commands Example");
+
+  // Initialize WISMO228
+  wismo.init();
+  
+  Serial.println("Powering up, please wait...");
+  
+  // Perform WISMO228 power up sequence
+  if (wismo.powerUp())
+  {
+    Serial.println("TraLog is awake!");
+    Serial.println("Send LED ON, LED OFF or STATUS to TraLog!");
+  }
+  else
+  {
+    Serial.println("Ugh, power up failed.");
+  }
+}
+
+void loop()                 
+{
+  // If new SMS is received
+  if (sms)
+  {
+    sms = false;
+    
+    // Read the new SMS & call its command handler
+    if (!wismo.processSms(commands, sizeof(commands) / sizeof(commands[0])))
+    {
+      Serial.println("Unknown command.");
+    }
+  }
+}
+
+/*******************************************************************************
+* Name: ledCommand
+* Description: Handler of the LED command.
+*
+* Argument     Description
+* =========    ===========
+* 1. sender    Phone number of the sender.
+*
+* 2. arguments "ON" or "OFF".
+*
+* Return       Description
+* =========	   ===========
+* 1. NIL			
+*
+*******************************************************************************/
+void    ledCommand(const char *, const char *arguments)
+{
+  if (strcasecmp(arguments, "ON") == 0)
+  {
+    digitalWrite(ledPin, HIGH);
+  }
+  else if (strcasecmp(arguments, "OFF") == 0)
+  {
+    digitalWrite(ledPin, LOW);
+  }
+}
+
+/*******************************************************************************
+* Name: statusCommand
+* Description: Handler of the STATUS command, replies LED state to the sender.
+*
+* Argument     Description
+* =========    ===========
+* 1. sender    Phone number of the sender.
+*
+* 2. arguments Not used.
+*
+* Return       Description
+* =========	   ===========
+* 1. NIL			
+*
+*******************************************************************************/
+void    statusCommand(const char *sender, const char *)
+{
+  char  recipient[SENDER_LENGTH_MAX + 1];
+  
+  // Sender is retrieved without the international "+" prefix
+  recipient[0] = '+';
+  strcpy(recipient + 1, sender);
+  
+  if (digitalRead(ledPin))
+  {
+    wismo.sendSms(recipient, "LED is on");
+  }
+  else
+  {
+    wismo.sendSms(recipient, "LED is off");
+  }
+}
+
+/*******************************************************************************
+* Name: newSms
+* Description: A handler for new SMS indication.
+*
+* Argument     Description
+* =========    ===========
+* 1. NIL				
+*
+* Return       Description
+* =========	   ===========
+* 1. NIL			
+*
+*******************************************************************************/
+void    newSms(void)
+{
+  sms = true;
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+* WISMO228 Library - TCP Server Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is an example on receiving configuration pushed by a back office over an
+* incoming TCP connection using the WISMO228 library on the TraLog Shield. 
+* Every line received is printed and acknowledged with "OK".
+*
+* ============
+* Requirements
+* ============
+* 1. UART selection switch to SW position (uses pin D5 (RX) & D6 (TX)).
+* 2. On v1 of the shield, jumper J14 is closed to allow usage of pin A2 to 
+*    control on-off state of WISMO228 module. On v2 of the shield, short the 
+*    jumper labelled A2 & GSM-ON. This is the default factory setting.
+* 3. You need to know your service provider APN name, username, and password. If
+*    they don't specify the username and password, you can use " ". Notice the
+*    space in between the quote mark. 
+* 4. A SIM card & APN which allows inbound connections (public IP address).
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial public release. Uses WISMO228 Library version 1.40.
+*******************************************************************************/
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+const  uint8_t  gsmRxPin = 5;
+const  uint8_t  gsmTxPin = 6;
+const  uint8_t  gsmOnOffPin = A2;
+
+// ***** CONSTANTS *****
+const  char  apn[] = "apn";
+const  char  username[] = "username";
+const  char  password[] = "password";
+const  char  serverPort[] = "5000";
+
+// ***** CLASSES *****
+// Software serial class
+SoftwareSerial gsm(gsmRxPin, gsmTxPin); 
+// WISMO228 class
+WISMO228  wismo(&gsm, gsmOnOffPin);
+
+// ***** VARIABLES *****
+// Socket of the accepted connection, 0 if none
+unsigned char client = 0;
+
+void setup()  
+{
+  Serial.begin(9600);
+  Serial.println(F("TCP Server Example"));
+
+  // Initialize WISMO228
+  wismo.init();
+  
+  Serial.println(F("Powering up, please wait..."));
+  
+  // Perform WISMO228 power up sequence
+  if (wismo.powerUp())
+  {
+    Serial.println(F("TraLog is awake!"));
+    
+    if (wismo.openGPRS(apn, username, password))
+    {
+      Serial.println(F("Connected to GPRS."));
+      
+      if (wismo.openServer(serverPort, newClient))
+      {
+        Serial.println(F("Waiting for connections."));
+      }
+    }
+    else
+    {
+      Serial.println(F("GPRS connection failed."));
+    }
+  }
+  else
+  {
+    Serial.println(F("Ugh, power up failed."));
+  }
+}
+
+void loop() 
+{  
+  char  data[32];
+  unsigned int  count;
+  
+  // Check for incoming connections
+  wismo.poll();
+  
+  if (client != 0)
+  {
+    count = wismo.readSocket(client, data, sizeof(data) - 1);
+    
+    if (count > 0)
+    {
+      data[count] = '\0';
+      Serial.print(data);
+      wismo.writeSocket(client, "OK\r\n", 4);
+    }
+  }
+}
+
+/*******************************************************************************
+* Name: newClient
+* Description: A handler for accepted connections.
+*
+* Argument     Description
+* =========    ===========
+* 1. socket    Socket of the accepted connection.
+*
+* Return       Description
+* =========	   ===========
+* 1. NIL			
+*
+*******************************************************************************/
+void newClient(unsigned char socket)
+{
+  // Only serve the latest connection
+  if (client != 0)
+  {
+    wismo.closeSocket(client);
+  }
+  
+  client = socket;
+  Serial.println(F("Client connected."));
+}
@@ -0,0 +1,187 @@
+/*******************************************************************************
+* WISMO228 Library - UDP Example
+* Version: 1.00
+* Date: 18-10-2026
+* Company: Rocket Scream Electronics
+* Author: Lim Phang Moh
+* Website: www.rocketscream.com
+*
+* This is an example on sending sensor readings as UDP datagrams using the 
+* WISMO228 library on the TraLog Shield. Each sample is sent once as an 
+* acknowledged datagram and once through HTTP PUT, and the latency & estimated
+* bytes on air of both methods are printed for comparison.
+*
+* ============
+* Requirements
+* ============
+* 1. UART selection switch to SW position (uses pin D5 (RX) & D6 (TX)).
+* 2. On v1 of the shield, jumper J14 is closed to allow usage of pin A2 to 
+*    control on-off state of WISMO228 module. On v2 of the shield, short the 
+*    jumper labelled A2 & GSM-ON. This is the default factory setting.
+* 3. You need to know your service provider APN name, username, and password. If
+*    they don't specify the username and password, you can use " ". Notice the
+*    space in between the quote mark. 
+* 4. A UDP server which replies to every datagram with the first 5 characters
+*    (sequence number & comma) of the received datagram.
+* 5. A HTTP server accepting PUT request for the comparison.
+* 6. An analog sensor connected to pin A5. You can use an LDR for this example.
+*
+* ============
+* Bytes on air
+* ============
+* Estimates exclude GPRS link layer overhead. 
+* UDP: IP & UDP headers (28 bytes) for the datagram and it's acknowledgement.
+* HTTP: IP & TCP headers (40 bytes) for 3 segments of connection setup, 4 
+*       segments of connection release, request & response segments plus the 
+*       request and a typical 150 bytes response.
+*
+* This example is licensed under Creative Commons Attribution-ShareAlike 3.0 
+* Unported License. 
+*
+* Revision  Description
+* ========  ===========
+* 1.00      Initial public release. Uses WISMO228 Library version 1.40.
+*******************************************************************************/
+// ***** INCLUDES *****
+#include "SoftwareSerial.h"
+#include <WISMO228.h>
+
+// ***** PIN ASSIGNMENT *****
+const  uint8_t  gsmRxPin = 5;
+const  uint8_t  gsmTxPin = 6;
+const  uint8_t  gsmOnOffPin = A2;
+const  uint8_t  sensorPin = A5;
+
+// ***** CONSTANTS *****
+const  char  apn[] = "apn";
+const  char  username[] = "username";
+const  char  password[] = "password";
+// ***** UDP PARAMETERS *****
+const  char  udpServer[] = "udp.yourdomain.com";
+const  char  udpPort[] = "5000";
+// ***** HTTP PARAMETERS *****
+const  char  httpServer[] = "www.yourdomain.com";
+const  char  httpPath[] = "/sensor.csv";
+const  char  httpPort[] = "80";
+const  char  controlKey[] = "X-ApiKey: InsertYourKeyHere";
+const  char  contentType[] = "text/csv";
+#define UDP_OVERHEAD  28
+#define TCP_OVERHEAD  40
+#define TCP_SEGMENTS  9
+#define HTTP_HEADERS  100
+#define HTTP_RESPONSE 150
+#define UPDATE_INTERVAL 60000
+
+// ***** CLASSES *****
+// Software serial class
+SoftwareSerial gsm(gsmRxPin, gsmTxPin); 
+// WISMO228 class
+WISMO228  wismo(&gsm, gsmOnOffPin);
+
+// ***** VARIABLES *****
+char  data[16];
+unsigned long scheduler;
+
+void setup()  
+{
+  Serial.begin(9600);
+  Serial.println(F("UDP Example"));
+
+  // Initialize WISMO228
+  wismo.init();
+  
+  Serial.println(F("Powering up, please wait..."));
+  
+  // Perform WISMO228 power up sequence
+  if (wismo.powerUp())
+  {
+    Serial.println(F("TraLog is awake!"));
+    
+    // Connect to GPRS network once, the link is kept for all samples
+    if (wismo.openGPRS(apn, username, password))
+    {
+      Serial.println(F("Connected to GPRS."));
+      
+      if (wismo.openUdp(udpServer, udpPort))
+      {
+        Serial.println(F("UDP socket created."));
+      }
+    }
+    else
+    {
+      Serial.println(F("GPRS connection failed."));
+    }
+  }
+  else
+  {
+    Serial.println(F("Ugh, power up failed."));
+  }
+  
+  scheduler = millis();
+}
+
+void loop() 
+{  
+  if (millis() > scheduler)
+  {
+    scheduler = millis() + UPDATE_INTERVAL;
+    
+    // Read sensor & convert from int to string
+    itoa(analogRead(sensorPin), data, 10);
+    strcat(data, "\r\n");
+    
+    sendUdp();
+    sendHttp();
+  }
+}
+
+void sendUdp(void)
+{
+  unsigned long start;
+  unsigned int  bytes;
+  
+  start = millis();
+  
+  if (wismo.sendDatagram(data, strlen(data), true))
+  {
+    // Datagram with sequence number & it's acknowledgement
+    bytes = UDP_OVERHEAD + 5 + strlen(data) + UDP_OVERHEAD + 5;
+    
+    Serial.print(F("UDP: "));
+    Serial.print(millis() - start);
+    Serial.print(F(" ms, "));
+    Serial.print(bytes);
+    Serial.print(F(" bytes, lost: "));
+    Serial.println(wismo.getDatagramLoss());
+  }
+  else
+  {
+    Serial.println(F("UDP: not acknowledged."));
+  }
+}
+
+void sendHttp(void)
+{
+  unsigned long start;
+  unsigned int  bytes;
+  
+  start = millis();
+  
+  if (wismo.putHttp(httpServer, httpPath, httpPort, httpServer, data, 
+                    controlKey, contentType))
+  {
+    bytes = (TCP_OVERHEAD * TCP_SEGMENTS) + HTTP_HEADERS + strlen(httpPath) + 
+            strlen(httpServer) + strlen(controlKey) + strlen(contentType) + 
+            strlen(data) + HTTP_RESPONSE;
+    
+    Serial.print(F("HTTP: "));
+    Serial.print(millis() - start);
+    Serial.print(F(" ms, "));
+    Serial.print(bytes);
+    Serial.println(F(" bytes"));
+  }
+  else
+  {
+    Serial.println(F("HTTP: PUT failed."));
+  }
+}